@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include "../includes/allocator.hpp"
+#include "../includes/memory_pool.hpp"
+#include "../includes/memory_resource.hpp"
+#include "../includes/object_pool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t POOL_SIZE = 64 * pxd::memory::SIZE_1MB;
+
+/*
+ * makes a std::allocator or a pool allocator bound to the given pool
+ */
+template<class Alloc>
+auto
+make_allocator(pxd::memory::MemoryPool& pool) -> Alloc
+{
+  if constexpr (std::is_default_constructible_v<Alloc> &&
+                !std::is_constructible_v<Alloc, pxd::memory::MemoryPool&>) {
+    return Alloc();
+  }
+  else {
+    return Alloc(pool);
+  }
+}
+
+using MapValue = std::pair<const int, int>;
+
+template<class Alloc>
+void
+vector_push_back(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  pxd::memory::MemoryPool pool(POOL_SIZE);
+
+  for (auto _ : state) {
+    std::vector<int, Alloc> values(make_allocator<Alloc>(pool));
+
+    for (size_t i = 0; i < count; i++) {
+      values.push_back(static_cast<int>(i));
+    }
+
+    benchmark::DoNotOptimize(values.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+template<class Alloc>
+void
+list_push_back(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  pxd::memory::MemoryPool pool(POOL_SIZE);
+
+  for (auto _ : state) {
+    std::list<int, Alloc> values(make_allocator<Alloc>(pool));
+
+    for (size_t i = 0; i < count; i++) {
+      values.push_back(static_cast<int>(i));
+    }
+
+    benchmark::DoNotOptimize(values.back());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+template<class Alloc>
+void
+map_insert(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  pxd::memory::MemoryPool pool(POOL_SIZE);
+
+  for (auto _ : state) {
+    std::map<int, int, std::less<>, Alloc> values(make_allocator<Alloc>(pool));
+
+    for (size_t i = 0; i < count; i++) {
+      const auto key = static_cast<int>((i * 7919) % count);
+      values.emplace(key, key);
+    }
+
+    benchmark::DoNotOptimize(values.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/*
+ * the same pmr container on the new_delete resource and on the pool resource
+ */
+template<bool USE_POOL>
+void
+pmr_unordered_map(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  pxd::memory::MemoryPool    pool(POOL_SIZE);
+  pxd::memory::pool_resource pool_resource(pool);
+
+  std::pmr::memory_resource* resource =
+    USE_POOL ? &pool_resource : std::pmr::new_delete_resource();
+
+  for (auto _ : state) {
+    std::pmr::unordered_map<int, std::pmr::string> values(resource);
+
+    for (size_t i = 0; i < count; i++) {
+      values.emplace(static_cast<int>(i),
+                     "a string too long for the small string buffer");
+    }
+
+    benchmark::DoNotOptimize(values.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+BENCHMARK(vector_push_back<std::allocator<int>>)->Arg(10000);
+BENCHMARK(vector_push_back<pxd::memory::allocator<int>>)->Arg(10000);
+
+BENCHMARK(list_push_back<std::allocator<int>>)->Arg(10000);
+BENCHMARK(list_push_back<pxd::memory::allocator<int>>)->Arg(10000);
+BENCHMARK(list_push_back<pxd::memory::object_allocator<int>>)->Arg(10000);
+
+BENCHMARK(map_insert<std::allocator<MapValue>>)->Arg(10000);
+BENCHMARK(map_insert<pxd::memory::allocator<MapValue>>)->Arg(10000);
+BENCHMARK(map_insert<pxd::memory::object_allocator<MapValue>>)->Arg(10000);
+
+BENCHMARK(pmr_unordered_map<false>)->Arg(10000);
+BENCHMARK(pmr_unordered_map<true>)->Arg(10000);
+
+} // namespace
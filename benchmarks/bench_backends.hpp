@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../includes/basic_pool.hpp"
+#include "../includes/memory_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace pxd::bench {
+
+/*
+ * every workload is run once against the system malloc and once against a
+ * pool, the backends give both the same interface
+ */
+struct SystemBackend
+{
+  static constexpr const char* NAME = "system";
+
+  explicit SystemBackend(size_t /*capacity*/, bool /*thread_safe*/ = false) {}
+
+  [[nodiscard]] auto malloc(size_t size) noexcept -> void*
+  {
+    return std::malloc(size);
+  }
+
+  void free(void* ptr) noexcept { std::free(ptr); }
+};
+
+struct PoolBackend
+{
+  static constexpr const char* NAME = "pool";
+
+  explicit PoolBackend(size_t capacity, bool thread_safe = false)
+    : m_pool(capacity, make_options(thread_safe))
+  {
+  }
+
+  [[nodiscard]] auto malloc(size_t size) noexcept -> void*
+  {
+    return m_pool.malloc(size);
+  }
+
+  void free(void* ptr) noexcept { m_pool.free(ptr); }
+
+  [[nodiscard]] auto pool() noexcept -> memory::MemoryPool& { return m_pool; }
+
+private:
+  [[nodiscard]] static auto make_options(bool thread_safe) noexcept
+    -> memory::PoolOptions
+  {
+    memory::PoolOptions options = {};
+    options.thread_safe         = thread_safe;
+
+    return options;
+  }
+
+  memory::MemoryPool m_pool;
+};
+
+/*
+ * a basic_pool with the given fit policy and no lock, scrub or stats
+ */
+template<class Fit>
+struct BasicPoolBackend
+{
+  static constexpr const char* NAME = "basic_pool";
+
+  explicit BasicPoolBackend(size_t capacity, bool /*thread_safe*/ = false)
+    : m_pool(capacity)
+  {
+  }
+
+  [[nodiscard]] auto malloc(size_t size) noexcept -> void*
+  {
+    return m_pool.malloc(size);
+  }
+
+  void free(void* ptr) noexcept { m_pool.free(ptr); }
+
+private:
+  memory::basic_pool<Fit> m_pool;
+};
+
+/*
+ * sizes are drawn before the timed loop, so the random generator is not part
+ * of the measurement
+ */
+[[nodiscard]] inline auto
+random_sizes(size_t count, size_t min_size, size_t max_size, uint32_t seed)
+  -> std::vector<size_t>
+{
+  std::mt19937                          engine(seed);
+  std::uniform_int_distribution<size_t> distribution(min_size, max_size);
+
+  std::vector<size_t> sizes(count);
+
+  for (size_t& size : sizes) {
+    size = distribution(engine);
+  }
+
+  return sizes;
+}
+
+} // namespace pxd::bench
@@ -0,0 +1,321 @@
+#include <benchmark/benchmark.h>
+
+#include "../includes/monotonic_arena.hpp"
+#include "bench_backends.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+constexpr size_t POOL_SIZE = 64 * pxd::memory::SIZE_1MB;
+
+/*
+ * allocates and frees a block of the same size over and over
+ */
+template<class Backend>
+void
+fixed_size_churn(benchmark::State& state)
+{
+  const auto size = static_cast<size_t>(state.range(0));
+
+  Backend backend(POOL_SIZE);
+
+  for (auto _ : state) {
+    void* ptr = backend.malloc(size);
+    benchmark::DoNotOptimize(ptr);
+    backend.free(ptr);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * keeps a window of live blocks and replaces a pseudo random one with a block
+ * of a pseudo random size every iteration
+ */
+template<class Backend>
+void
+random_size_churn(benchmark::State& state)
+{
+  const auto live_count = static_cast<size_t>(state.range(0));
+
+  const std::vector<size_t> sizes =
+    pxd::bench::random_sizes(4096, 8, 1024, 42);
+  const std::vector<size_t> slots =
+    pxd::bench::random_sizes(4096, 0, live_count - 1, 7);
+
+  Backend            backend(POOL_SIZE);
+  std::vector<void*> blocks(live_count, nullptr);
+
+  for (size_t i = 0; i < live_count; i++) {
+    blocks[i] = backend.malloc(sizes[i % sizes.size()]);
+  }
+
+  size_t step = 0;
+
+  for (auto _ : state) {
+    const size_t slot = slots[step % slots.size()];
+
+    backend.free(blocks[slot]);
+    blocks[slot] = backend.malloc(sizes[step % sizes.size()]);
+    benchmark::DoNotOptimize(blocks[slot]);
+
+    step++;
+  }
+
+  for (void* block : blocks) {
+    backend.free(block);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * allocates a batch of blocks and frees them in the reverse order
+ */
+template<class Backend>
+void
+lifo_free(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  Backend            backend(POOL_SIZE);
+  std::vector<void*> blocks(count, nullptr);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      blocks[i] = backend.malloc(64);
+    }
+
+    for (size_t i = count; i > 0; i--) {
+      backend.free(blocks[i - 1]);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/*
+ * allocates a batch of blocks and frees them in the same order
+ */
+template<class Backend>
+void
+fifo_free(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  Backend            backend(POOL_SIZE);
+  std::vector<void*> blocks(count, nullptr);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      blocks[i] = backend.malloc(64);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      backend.free(blocks[i]);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/*
+ * frees every other block of an interleaved small and large batch, then asks
+ * for blocks which fit in none of the small holes
+ */
+template<class Backend>
+void
+fragmentation(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  Backend            backend(POOL_SIZE);
+  std::vector<void*> blocks(count, nullptr);
+  std::vector<void*> larges(count / 2, nullptr);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      blocks[i] = backend.malloc((i % 2 == 0) ? 32 : 256);
+    }
+
+    for (size_t i = 0; i < count; i += 2) {
+      backend.free(blocks[i]);
+    }
+
+    for (size_t i = 0; i < count / 2; i++) {
+      larges[i] = backend.malloc(128);
+    }
+
+    for (size_t i = 1; i < count; i += 2) {
+      backend.free(blocks[i]);
+    }
+
+    for (void* large : larges) {
+      backend.free(large);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(count + count / 2));
+}
+
+/*
+ * a request handler allocating a few dozen temporaries and dropping them all
+ * at the end
+ */
+template<class Backend>
+void
+request_temporaries(benchmark::State& state)
+{
+  const std::vector<size_t> sizes = pxd::bench::random_sizes(48, 16, 512, 3);
+
+  Backend            backend(POOL_SIZE);
+  std::vector<void*> blocks(sizes.size(), nullptr);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < sizes.size(); i++) {
+      blocks[i] = backend.malloc(sizes[i]);
+    }
+
+    benchmark::DoNotOptimize(blocks.data());
+
+    for (void* block : blocks) {
+      backend.free(block);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(sizes.size()));
+}
+
+void
+request_temporaries_arena(benchmark::State& state)
+{
+  const std::vector<size_t> sizes = pxd::bench::random_sizes(48, 16, 512, 3);
+
+  pxd::memory::MemoryPool      pool(POOL_SIZE);
+  pxd::memory::monotonic_arena arena(pool);
+
+  for (auto _ : state) {
+    pxd::memory::arena_scope scope(arena);
+
+    for (const size_t size : sizes) {
+      benchmark::DoNotOptimize(arena.allocate(size));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(sizes.size()));
+}
+
+/*
+ * a decoder allocating the same sized buffers for a packet and freeing them
+ * together, one by one or as a batch
+ */
+template<bool USE_BATCH>
+void
+packet_buffers(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  pxd::memory::MemoryPool pool(POOL_SIZE);
+  std::vector<void*>      blocks(count, nullptr);
+
+  for (auto _ : state) {
+    if constexpr (USE_BATCH) {
+      if (!pool.malloc_batch(128, count, blocks.data())) {
+        state.SkipWithError("the pool is full");
+        break;
+      }
+
+      pool.free_batch(blocks.data(), count);
+    }
+    else {
+      for (void*& block : blocks) {
+        block = pool.malloc(128);
+      }
+
+      for (void* block : blocks) {
+        pool.free(block);
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+/*
+ * scans block sizes of which only the last one fits, at the given simd level
+ * or the highest one the cpu has below it
+ */
+template<pxd::memory::SimdLevel Level>
+void
+fit_search(benchmark::State& state)
+{
+  const auto count = static_cast<size_t>(state.range(0));
+
+  std::vector<size_t> sizes = pxd::bench::random_sizes(count, 8, 1023, 42);
+  sizes.back()              = 4096;
+
+  for (auto _ : state) {
+    size_t position =
+      pxd::memory::find_first_at_least(sizes.data(), count, 1024, Level);
+    benchmark::DoNotOptimize(position);
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+using pxd::bench::BasicPoolBackend;
+using pxd::bench::PoolBackend;
+using pxd::bench::SystemBackend;
+
+using FirstFitBackend     = BasicPoolBackend<pxd::memory::policy::first_fit>;
+using NextFitBackend      = BasicPoolBackend<pxd::memory::policy::next_fit>;
+using BestFitBackend      = BasicPoolBackend<pxd::memory::policy::best_fit>;
+using SizeClassFitBackend =
+  BasicPoolBackend<pxd::memory::policy::size_class_fit>;
+using SimdFirstFitBackend =
+  BasicPoolBackend<pxd::memory::policy::simd_first_fit>;
+
+BENCHMARK(fixed_size_churn<SystemBackend>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(fixed_size_churn<PoolBackend>)->Arg(16)->Arg(256)->Arg(4096);
+
+BENCHMARK(random_size_churn<SystemBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<PoolBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<FirstFitBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<NextFitBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<BestFitBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<SizeClassFitBackend>)->Arg(64)->Arg(4096);
+BENCHMARK(random_size_churn<SimdFirstFitBackend>)->Arg(64)->Arg(4096);
+
+BENCHMARK(lifo_free<SystemBackend>)->Arg(1024);
+BENCHMARK(lifo_free<PoolBackend>)->Arg(1024);
+
+BENCHMARK(fifo_free<SystemBackend>)->Arg(1024);
+BENCHMARK(fifo_free<PoolBackend>)->Arg(1024);
+
+BENCHMARK(fragmentation<SystemBackend>)->Arg(1024);
+BENCHMARK(fragmentation<PoolBackend>)->Arg(1024);
+BENCHMARK(fragmentation<FirstFitBackend>)->Arg(1024);
+BENCHMARK(fragmentation<NextFitBackend>)->Arg(1024);
+BENCHMARK(fragmentation<BestFitBackend>)->Arg(1024);
+BENCHMARK(fragmentation<SizeClassFitBackend>)->Arg(1024);
+BENCHMARK(fragmentation<SimdFirstFitBackend>)->Arg(1024);
+
+BENCHMARK(fit_search<pxd::memory::SimdLevel::SCALAR>)->Arg(64)->Arg(4096);
+BENCHMARK(fit_search<pxd::memory::SimdLevel::SSE4_2>)->Arg(64)->Arg(4096);
+BENCHMARK(fit_search<pxd::memory::SimdLevel::AVX2>)->Arg(64)->Arg(4096);
+BENCHMARK(fit_search<pxd::memory::SimdLevel::AVX512>)->Arg(64)->Arg(4096);
+
+BENCHMARK(request_temporaries<SystemBackend>);
+BENCHMARK(request_temporaries<PoolBackend>);
+BENCHMARK(request_temporaries_arena);
+
+BENCHMARK(packet_buffers<false>)->Arg(32);
+BENCHMARK(packet_buffers<true>)->Arg(32);
+
+} // namespace
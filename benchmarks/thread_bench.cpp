@@ -0,0 +1,231 @@
+#include <benchmark/benchmark.h>
+
+#include "../includes/concurrent_block_pool.hpp"
+#include "bench_backends.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t POOL_SIZE = 256 * pxd::memory::SIZE_1MB;
+
+/*
+ * every thread of a run shares the same backend, the first thread creates it
+ * and the last one to leave destroys it
+ */
+template<class Backend>
+std::unique_ptr<Backend> g_backend;
+
+template<class Backend>
+void
+parallel_churn(benchmark::State& state)
+{
+  if (state.thread_index() == 0) {
+    g_backend<Backend> = std::make_unique<Backend>(POOL_SIZE, true);
+  }
+
+  const std::vector<size_t> sizes = pxd::bench::random_sizes(
+    1024, 8, 512, static_cast<uint32_t>(state.thread_index() + 1));
+
+  std::vector<void*> blocks(64, nullptr);
+  size_t             step = 0;
+
+  for (auto _ : state) {
+    for (void*& block : blocks) {
+      block = g_backend<Backend>->malloc(sizes[step++ % sizes.size()]);
+      benchmark::DoNotOptimize(block);
+    }
+
+    for (void* block : blocks) {
+      g_backend<Backend>->free(block);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(blocks.size()));
+
+  if (state.thread_index() == 0) {
+    g_backend<Backend>.reset();
+  }
+}
+
+constexpr size_t MESSAGE_SIZE = 256;
+
+/*
+ * fixed size blocks from a concurrent_block_pool, the sizes asked for are at
+ * most MESSAGE_SIZE
+ */
+struct ConcurrentBlockBackend
+{
+  static constexpr const char* NAME = "concurrent_block_pool";
+
+  explicit ConcurrentBlockBackend(size_t capacity, bool /*thread_safe*/ = false)
+    : m_pool(capacity + pxd::memory::SIZE_1MB)
+    , m_blocks(m_pool, MESSAGE_SIZE, capacity / MESSAGE_SIZE)
+  {
+  }
+
+  [[nodiscard]] auto malloc(size_t /*size*/) noexcept -> void*
+  {
+    return m_blocks.allocate();
+  }
+
+  void free(void* ptr) noexcept { m_blocks.deallocate(ptr); }
+
+private:
+  pxd::memory::MemoryPool            m_pool;
+  pxd::memory::concurrent_block_pool m_blocks;
+};
+
+/*
+ * every thread allocates a batch of message sized blocks and frees them, all
+ * of them against one shared backend
+ */
+template<class Backend>
+void
+parallel_messages(benchmark::State& state)
+{
+  if (state.thread_index() == 0) {
+    g_backend<Backend> = std::make_unique<Backend>(POOL_SIZE, true);
+  }
+
+  std::vector<void*> blocks(64, nullptr);
+
+  for (auto _ : state) {
+    for (void*& block : blocks) {
+      block = g_backend<Backend>->malloc(MESSAGE_SIZE);
+      benchmark::DoNotOptimize(block);
+    }
+
+    for (void* block : blocks) {
+      g_backend<Backend>->free(block);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(blocks.size()));
+
+  if (state.thread_index() == 0) {
+    g_backend<Backend>.reset();
+  }
+}
+
+/*
+ * a single producer single consumer ring which hands the blocks from one
+ * thread to the next
+ */
+struct MessageRing
+{
+  static constexpr size_t SLOT_COUNT = 1024;
+
+  auto push(void* block) noexcept -> bool
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+    if (tail - m_head.load(std::memory_order_acquire) == SLOT_COUNT) {
+      return false;
+    }
+
+    m_slots[tail % SLOT_COUNT] = block;
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  auto pop() noexcept -> void*
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    void* block = m_slots[head % SLOT_COUNT];
+    m_head.store(head + 1, std::memory_order_release);
+
+    return block;
+  }
+
+private:
+  alignas(64) std::atomic<size_t> m_head = 0;
+  alignas(64) std::atomic<size_t> m_tail = 0;
+  std::array<void*, SLOT_COUNT>   m_slots = {};
+};
+
+std::unique_ptr<std::vector<MessageRing>> g_rings;
+
+/*
+ * the even threads allocate messages and hand them to the next odd thread,
+ * which frees them, so every block is freed by another thread than the one
+ * which allocated it
+ */
+template<class Backend>
+void
+pipeline(benchmark::State& state)
+{
+  if (state.thread_index() == 0) {
+    g_backend<Backend> = std::make_unique<Backend>(POOL_SIZE, true);
+    g_rings = std::make_unique<std::vector<MessageRing>>(
+      static_cast<size_t>(state.threads()) / 2);
+  }
+
+  const bool producer   = state.thread_index() % 2 == 0;
+  const auto ring_index = static_cast<size_t>(state.thread_index()) / 2;
+
+  for (auto _ : state) {
+    MessageRing& ring = (*g_rings)[ring_index];
+
+    if (producer) {
+      void* block = g_backend<Backend>->malloc(MESSAGE_SIZE);
+
+      while (block == nullptr) {
+        std::this_thread::yield();
+        block = g_backend<Backend>->malloc(MESSAGE_SIZE);
+      }
+
+      while (!ring.push(block)) {
+        std::this_thread::yield();
+      }
+    }
+    else {
+      void* block = ring.pop();
+
+      while (block == nullptr) {
+        std::this_thread::yield();
+        block = ring.pop();
+      }
+
+      g_backend<Backend>->free(block);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    g_rings.reset();
+    g_backend<Backend>.reset();
+  }
+}
+
+using pxd::bench::PoolBackend;
+using pxd::bench::SystemBackend;
+
+BENCHMARK(parallel_churn<SystemBackend>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(parallel_churn<PoolBackend>)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(parallel_messages<SystemBackend>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(parallel_messages<PoolBackend>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(parallel_messages<ConcurrentBlockBackend>)
+  ->ThreadRange(1, 8)
+  ->UseRealTime();
+
+BENCHMARK(pipeline<SystemBackend>)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(pipeline<PoolBackend>)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(pipeline<ConcurrentBlockBackend>)->ThreadRange(2, 8)->UseRealTime();
+
+} // namespace
@@ -8,6 +8,10 @@
 
 namespace pxd::memory {
 
+/*
+ * allocates from the pool given at construction, the default pool if none is
+ * given. containers copy the pool together with the allocator
+ */
 template<class T>
 struct allocator
 {
@@ -18,9 +22,27 @@ struct allocator
   using const_reference                        = const T&;
   using size_type                              = std::size_t;
   using difference_type                        = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
   using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap            = std::true_type;
+  using is_always_equal                        = std::false_type;
+
+  allocator() noexcept
+    : m_pool(&default_pool())
+  {
+  }
+
+  explicit allocator(MemoryPool& pool) noexcept
+    : m_pool(&pool)
+  {
+  }
+
+  template<class U>
+  allocator(const allocator<U>& other) noexcept
+    : m_pool(other.pool())
+  {
+  }
 
-  allocator()                                  = default;
   allocator(const allocator& other)            = default;
   allocator& operator=(const allocator& other) = default;
   allocator(allocator&& other)                 = default;
@@ -33,7 +55,8 @@ struct allocator
       throw std::bad_array_new_length();
     }
 
-    void* ptr = pxd::memory::malloc(n * sizeof(value_type));
+    void* ptr =
+      m_pool->aligned_malloc(n * sizeof(value_type), alignof(value_type));
 
     if (nullptr == ptr) {
       throw std::bad_alloc();
@@ -42,7 +65,22 @@ struct allocator
     return static_cast<pointer>(ptr);
   }
 
-  constexpr void deallocate(T* p, size_type n) { pxd::memory::free(p); }
+  constexpr void deallocate(T* p, size_type n)
+  {
+    m_pool->free(p, n * sizeof(value_type));
+  }
+
+  [[nodiscard]] auto pool() const noexcept -> MemoryPool* { return m_pool; }
+
+private:
+  MemoryPool* m_pool;
 };
 
+template<class T, class U>
+auto
+operator==(const allocator<T>& lhs, const allocator<U>& rhs) noexcept -> bool
+{
+  return lhs.pool() == rhs.pool();
+}
+
 } // namespace pxd::memory
@@ -0,0 +1,766 @@
+#pragma once
+
+#include "free_tree.hpp"
+#include "memory_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pxd::memory {
+
+/*
+ * a free block of a basic_pool, which keeps nothing but its size
+ */
+struct FreeBlock
+{
+  size_t total_size = 0;
+
+  void join(const FreeBlock& other) noexcept { total_size += other.total_size; }
+};
+
+using FreeBlocks = free_tree<size_t, FreeBlock>;
+
+/*
+ * the vector instructions a linear search over block sizes can use, each
+ * level includes the ones before it
+ */
+enum class SimdLevel : uint8_t
+{
+  SCALAR,
+  SSE4_2,
+  AVX2,
+  AVX512
+};
+
+/*
+ * the highest level the cpu and the operating system support, detected once
+ */
+[[nodiscard]] auto
+simd_level() noexcept -> SimdLevel;
+
+/*
+ * the index of the first of the count sizes which is at least the given size,
+ * count if there is none. compares as many sizes per instruction as the
+ * simd_level allows
+ */
+[[nodiscard]] auto
+find_first_at_least(const size_t* sizes, size_t count, size_t size) noexcept
+  -> size_t;
+
+/*
+ * the same search at the given level, or at simd_level if the cpu does not
+ * support it
+ */
+[[nodiscard]] auto
+find_first_at_least(const size_t* sizes,
+                    size_t        count,
+                    size_t        size,
+                    SimdLevel     level) noexcept -> size_t;
+
+namespace policy {
+
+[[nodiscard]] constexpr auto
+aligned_padding(uintptr_t address, size_t alignment) noexcept -> size_t
+{
+  return (alignment - (address % alignment)) % alignment;
+}
+
+/*
+ * whether the size fits into the free block once its start is aligned
+ */
+[[nodiscard]] constexpr auto
+block_fits(uintptr_t origin,
+           size_t    start_index,
+           size_t    block_size,
+           size_t    size,
+           size_t    alignment) noexcept -> bool
+{
+  return aligned_padding(origin + start_index, alignment) + size <= block_size;
+}
+
+// -----------------------------------------------------------------------------
+// -- Fit Policies
+
+/*
+ * a fit policy is told about every free block which is inserted or erased and
+ * returns the free block an allocation goes into, the end of the free blocks
+ * if none fits
+ */
+
+/*
+ * takes the free block with the lowest address. keeps no index of its own,
+ * but every search walks the small blocks left at the front
+ */
+struct first_fit
+{
+  void insert(size_t /*start_index*/, size_t /*size*/) noexcept {}
+  void erase(size_t /*start_index*/, size_t /*size*/) noexcept {}
+
+  [[nodiscard]] auto find(const FreeBlocks& blocks,
+                          uintptr_t         origin,
+                          size_t            size,
+                          size_t            alignment) noexcept
+    -> FreeBlocks::const_iterator
+  {
+    return std::find_if(
+      blocks.begin(), blocks.end(), [&](const auto& block) noexcept {
+        return block_fits(
+          origin, block.first, block.second.total_size, size, alignment);
+      });
+  }
+};
+
+/*
+ * first fit which goes on from the block of the last allocation, so the
+ * searches do not all walk the same blocks at the front
+ */
+struct next_fit
+{
+  void insert(size_t /*start_index*/, size_t /*size*/) noexcept {}
+  void erase(size_t /*start_index*/, size_t /*size*/) noexcept {}
+
+  [[nodiscard]] auto find(const FreeBlocks& blocks,
+                          uintptr_t         origin,
+                          size_t            size,
+                          size_t            alignment) noexcept
+    -> FreeBlocks::const_iterator
+  {
+    const auto fits = [&](const auto& block) noexcept {
+      return block_fits(
+        origin, block.first, block.second.total_size, size, alignment);
+    };
+
+    const auto cursor = blocks.lower_bound(m_cursor);
+    auto       found  = std::find_if(cursor, blocks.end(), fits);
+
+    if (found == blocks.end()) {
+      found = std::find_if(blocks.begin(), cursor, fits);
+
+      if (found == cursor) {
+        return blocks.end();
+      }
+    }
+
+    m_cursor = found->first;
+
+    return found;
+  }
+
+private:
+  size_t m_cursor = 0;
+};
+
+/*
+ * first fit over a copy of the free blocks kept in two arrays in address
+ * order, the sizes in one of them, so find_first_at_least compares several
+ * sizes per instruction. inserting and erasing move the tail of the arrays
+ */
+struct simd_first_fit
+{
+  void insert(size_t start_index, size_t size)
+  {
+    const auto position = position_of(start_index);
+
+    m_starts.insert(m_starts.begin() + position, start_index);
+    m_sizes.insert(m_sizes.begin() + position, size);
+  }
+
+  void erase(size_t start_index, size_t /*size*/) noexcept
+  {
+    const auto position = position_of(start_index);
+
+    m_starts.erase(m_starts.begin() + position);
+    m_sizes.erase(m_sizes.begin() + position);
+  }
+
+  [[nodiscard]] auto find(const FreeBlocks& blocks,
+                          uintptr_t         origin,
+                          size_t            size,
+                          size_t            alignment) noexcept
+    -> FreeBlocks::const_iterator
+  {
+    for (size_t position = 0; position < m_sizes.size(); position++) {
+      position += find_first_at_least(
+        m_sizes.data() + position, m_sizes.size() - position, size);
+
+      if (position == m_sizes.size()) {
+        break;
+      }
+
+      if (block_fits(
+            origin, m_starts[position], m_sizes[position], size, alignment)) {
+        return blocks.find(m_starts[position]);
+      }
+    }
+
+    return blocks.end();
+  }
+
+private:
+  [[nodiscard]] auto position_of(size_t start_index) const noexcept
+    -> std::ptrdiff_t
+  {
+    return std::lower_bound(m_starts.begin(), m_starts.end(), start_index) -
+           m_starts.begin();
+  }
+
+  std::vector<size_t> m_starts;
+  std::vector<size_t> m_sizes;
+};
+
+/*
+ * takes the smallest free block that fits, which keeps the large blocks
+ * intact at the cost of a second index ordered by size
+ */
+struct best_fit
+{
+  void insert(size_t start_index, size_t size)
+  {
+    m_by_size.emplace(size, start_index);
+  }
+
+  void erase(size_t start_index, size_t size) noexcept
+  {
+    m_by_size.erase({ size, start_index });
+  }
+
+  [[nodiscard]] auto find(const FreeBlocks& blocks,
+                          uintptr_t         origin,
+                          size_t            size,
+                          size_t            alignment) noexcept
+    -> FreeBlocks::const_iterator
+  {
+    for (auto iter = m_by_size.lower_bound({ size, 0 });
+         iter != m_by_size.end();
+         ++iter) {
+      if (block_fits(origin, iter->second, iter->first, size, alignment)) {
+        return blocks.find(iter->second);
+      }
+    }
+
+    return blocks.end();
+  }
+
+private:
+  std::set<std::pair<size_t, size_t>> m_by_size;
+};
+
+/*
+ * keeps the free blocks in power of two size classes and takes the lowest
+ * block of the smallest class holding one that fits. a bitmap of the classes
+ * in use finds the class, so the search rarely looks at more than one block
+ */
+struct size_class_fit
+{
+  static constexpr size_t CLASS_COUNT = 64;
+
+  void insert(size_t start_index, size_t size)
+  {
+    const size_t size_class = class_of(size);
+
+    m_classes[size_class].emplace(start_index, size);
+    m_class_map |= uint64_t{ 1 } << size_class;
+  }
+
+  void erase(size_t start_index, size_t size) noexcept
+  {
+    const size_t size_class = class_of(size);
+
+    m_classes[size_class].erase({ start_index, size });
+
+    if (m_classes[size_class].empty()) {
+      m_class_map &= ~(uint64_t{ 1 } << size_class);
+    }
+  }
+
+  [[nodiscard]] auto find(const FreeBlocks& blocks,
+                          uintptr_t         origin,
+                          size_t            size,
+                          size_t            alignment) noexcept
+    -> FreeBlocks::const_iterator
+  {
+    uint64_t candidates = m_class_map & (~uint64_t{ 0 } << class_of(size));
+
+    while (candidates != 0) {
+      const auto size_class =
+        static_cast<size_t>(std::countr_zero(candidates));
+
+      for (const auto& [start_index, block_size] : m_classes[size_class]) {
+        if (block_fits(origin, start_index, block_size, size, alignment)) {
+          return blocks.find(start_index);
+        }
+      }
+
+      candidates &= candidates - 1;
+    }
+
+    return blocks.end();
+  }
+
+private:
+  [[nodiscard]] static auto class_of(size_t size) noexcept -> size_t
+  {
+    return static_cast<size_t>(std::bit_width(size)) - 1;
+  }
+
+  std::array<std::set<std::pair<size_t, size_t>>, CLASS_COUNT> m_classes;
+  uint64_t                                                     m_class_map = 0;
+};
+
+// -----------------------------------------------------------------------------
+// -- Lock Policies
+
+struct null_lock
+{
+  void lock() noexcept {}
+  void unlock() noexcept {}
+};
+
+using mutex_lock = std::mutex;
+
+// -----------------------------------------------------------------------------
+// -- Scrub Policies
+
+/*
+ * ZEROES_ALLOCATIONS tells whether every allocation is zero already, so
+ * calloc does not clear it again
+ */
+
+struct no_scrub
+{
+  static constexpr bool ZEROES_ALLOCATIONS = false;
+
+  static void on_alloc(void* /*mem_pointer*/, size_t /*size*/) noexcept {}
+  static void on_free(void* /*mem_pointer*/, size_t /*size*/) noexcept {}
+};
+
+/*
+ * the arena starts zeroed, so keeping the freed memory zero keeps every free
+ * block zero
+ */
+struct zero_on_free
+{
+  static constexpr bool ZEROES_ALLOCATIONS = true;
+
+  static void on_alloc(void* /*mem_pointer*/, size_t /*size*/) noexcept {}
+  static void on_free(void* mem_pointer, size_t size) noexcept
+  {
+    std::memset(mem_pointer, 0, size);
+  }
+};
+
+struct zero_on_alloc
+{
+  static constexpr bool ZEROES_ALLOCATIONS = true;
+
+  static void on_alloc(void* mem_pointer, size_t size) noexcept
+  {
+    std::memset(mem_pointer, 0, size);
+  }
+  static void on_free(void* /*mem_pointer*/, size_t /*size*/) noexcept {}
+};
+
+// -----------------------------------------------------------------------------
+// -- Stats Policies
+
+/*
+ * a stats policy is told about the allocations and, like the fit policy,
+ * about every free block which is inserted or erased
+ */
+
+struct null_stats
+{
+  void on_alloc(size_t /*size*/) noexcept {}
+  void on_free(size_t /*size*/) noexcept {}
+  void on_resize(size_t /*old_size*/, size_t /*size*/) noexcept {}
+  void on_fail() noexcept {}
+  void on_insert_free(size_t /*size*/) noexcept {}
+  void on_erase_free(size_t /*size*/) noexcept {}
+  void fill(PoolStats& /*stats*/) const noexcept {}
+};
+
+/*
+ * keeps the count of the free blocks of every size, so the largest and the
+ * smallest one are the ends of an ordered map
+ */
+struct counting_stats
+{
+  void on_alloc(size_t size) noexcept
+  {
+    m_allocated_bytes += size;
+    m_peak_bytes       = std::max(m_peak_bytes, m_allocated_bytes);
+    m_alloc_count++;
+  }
+
+  void on_free(size_t size) noexcept
+  {
+    m_allocated_bytes -= size;
+    m_free_count++;
+  }
+
+  void on_resize(size_t old_size, size_t size) noexcept
+  {
+    m_allocated_bytes = m_allocated_bytes - old_size + size;
+    m_peak_bytes      = std::max(m_peak_bytes, m_allocated_bytes);
+  }
+
+  void on_fail() noexcept { m_failed_count++; }
+
+  void on_insert_free(size_t size) { m_free_sizes[size]++; }
+
+  void on_erase_free(size_t size) noexcept
+  {
+    auto size_iter = m_free_sizes.find(size);
+
+    if (--size_iter->second == 0) {
+      m_free_sizes.erase(size_iter);
+    }
+  }
+
+  void fill(PoolStats& stats) const noexcept
+  {
+    stats.allocated_bytes = m_allocated_bytes;
+    stats.peak_bytes      = m_peak_bytes;
+    stats.alloc_count     = m_alloc_count;
+    stats.free_count      = m_free_count;
+    stats.failed_count    = m_failed_count;
+
+    if (!m_free_sizes.empty()) {
+      stats.largest_free_block  = m_free_sizes.rbegin()->first;
+      stats.smallest_free_block = m_free_sizes.begin()->first;
+    }
+  }
+
+private:
+  size_t                   m_allocated_bytes = 0;
+  size_t                   m_peak_bytes      = 0;
+  size_t                   m_alloc_count     = 0;
+  size_t                   m_free_count      = 0;
+  size_t                   m_failed_count    = 0;
+  std::map<size_t, size_t> m_free_sizes;
+};
+
+} // namespace policy
+
+/*
+ * a pool whose strategies are chosen at compile time instead of through
+ * PoolOptions. the fit policy picks the free block of an allocation, the lock
+ * policy guards the calls, the scrub policy clears the memory and the stats
+ * policy keeps the counters. the null policies are empty, so they cost
+ * neither space nor instructions. the arena is a fixed block of zeroed memory
+ * from the system allocator
+ */
+template<class Fit   = policy::size_class_fit,
+         class Lock  = policy::null_lock,
+         class Scrub = policy::no_scrub,
+         class Stats = policy::null_stats>
+class basic_pool
+{
+public:
+  explicit basic_pool(size_t size)
+    : m_data(static_cast<std::byte*>(std::calloc(size == 0 ? 1 : size, 1)))
+    , m_size(size)
+  {
+    if (m_data == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    if (size > 0) {
+      m_free.insert(0, FreeBlock{ size }, hooks());
+    }
+  }
+
+  basic_pool(const basic_pool& other)            = delete;
+  basic_pool& operator=(const basic_pool& other) = delete;
+  basic_pool(basic_pool&& other)                 = delete;
+  basic_pool& operator=(basic_pool&& other)      = delete;
+  ~basic_pool() noexcept                         = default;
+
+  [[nodiscard]] auto malloc(size_t size) noexcept -> void*
+  {
+    return aligned_malloc(size, 1);
+  }
+
+  [[nodiscard]] auto calloc(size_t size) noexcept -> void*
+  {
+    return aligned_calloc(size, 1);
+  }
+
+  /*
+   * the alignment has to be a power of two
+   */
+  [[nodiscard]] auto aligned_malloc(size_t size, size_t alignment) noexcept
+    -> void*
+  {
+    if (size == 0 || !std::has_single_bit(alignment)) {
+      return nullptr;
+    }
+
+    const std::lock_guard<Lock> lock(m_lock);
+
+    return allocate(size, alignment);
+  }
+
+  [[nodiscard]] auto aligned_calloc(size_t size, size_t alignment) noexcept
+    -> void*
+  {
+    void* ptr = aligned_malloc(size, alignment);
+
+    if constexpr (!Scrub::ZEROES_ALLOCATIONS) {
+      if (ptr != nullptr) {
+        std::memset(ptr, 0, size);
+      }
+    }
+
+    return ptr;
+  }
+
+  /*
+   * resizes in place when the block after the allocation is free, moves it
+   * otherwise. on failure the old allocation is left as is
+   */
+  [[nodiscard]] auto realloc(void* mem_pointer, size_t size) noexcept -> void*
+  {
+    if (mem_pointer == nullptr) {
+      return malloc(size);
+    }
+
+    if (size == 0) {
+      free(mem_pointer);
+      return nullptr;
+    }
+
+    if (!owns(mem_pointer)) {
+      return nullptr;
+    }
+
+    const std::lock_guard<Lock> lock(m_lock);
+
+    auto found_iter = m_allocated.find(index_of(mem_pointer));
+
+    if (found_iter == m_allocated.end()) {
+      return nullptr;
+    }
+
+    if (resize(found_iter, size)) {
+      return mem_pointer;
+    }
+
+    /*
+     * the moved block keeps the alignment of the old one, up to the alignment
+     * malloc of the system would give
+     */
+    const size_t alignment = std::min(
+      size_t{ 1 } << std::countr_zero(reinterpret_cast<uintptr_t>(mem_pointer)),
+      alignof(std::max_align_t));
+
+    void* moved = allocate(size, alignment);
+
+    if (moved != nullptr) {
+      std::memcpy(moved, mem_pointer, found_iter->second);
+      deallocate(found_iter);
+    }
+
+    return moved;
+  }
+
+  void free(void* mem_pointer) noexcept
+  {
+    if (!owns(mem_pointer)) {
+      return;
+    }
+
+    const std::lock_guard<Lock> lock(m_lock);
+
+    auto found_iter = m_allocated.find(index_of(mem_pointer));
+
+    if (found_iter != m_allocated.end()) {
+      deallocate(found_iter);
+    }
+  }
+
+  [[nodiscard]] auto owns(const void* mem_pointer) const noexcept -> bool
+  {
+    const auto address = reinterpret_cast<uintptr_t>(mem_pointer);
+
+    return address >= origin() && address < origin() + m_size;
+  }
+
+  /*
+   * the bytes the allocation can use, zero if it is not allocated from the
+   * pool
+   */
+  [[nodiscard]] auto usable_size(const void* mem_pointer) noexcept -> size_t
+  {
+    if (!owns(mem_pointer)) {
+      return 0;
+    }
+
+    const std::lock_guard<Lock> lock(m_lock);
+
+    auto found_iter = m_allocated.find(index_of(mem_pointer));
+
+    return found_iter == m_allocated.end() ? 0 : found_iter->second;
+  }
+
+  /*
+   * the counters come from the stats policy and stay zero with null_stats,
+   * the free bytes are the running total of the free blocks
+   */
+  auto stats() -> PoolStats
+  {
+    const std::lock_guard<Lock> lock(m_lock);
+
+    PoolStats stats = {};
+    m_stats.fill(stats);
+
+    stats.free_bytes = m_free.free_bytes();
+
+    return stats;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> size_t { return m_size; }
+
+private:
+  using AllocatedIndex = std::unordered_map<size_t, size_t>;
+
+  struct FreeDeleter
+  {
+    void operator()(std::byte* data) const noexcept { std::free(data); }
+  };
+
+  [[nodiscard]] auto origin() const noexcept -> uintptr_t
+  {
+    return reinterpret_cast<uintptr_t>(m_data.get());
+  }
+
+  [[nodiscard]] auto index_of(const void* mem_pointer) const noexcept -> size_t
+  {
+    return reinterpret_cast<uintptr_t>(mem_pointer) - origin();
+  }
+
+  /*
+   * tells the fit and the stats policy about the free blocks the tree inserts
+   * and erases
+   */
+  struct PolicyHooks
+  {
+    Fit&   fit;
+    Stats& stats;
+
+    void insert(size_t start_index, const FreeBlock& block)
+    {
+      fit.insert(start_index, block.total_size);
+      stats.on_insert_free(block.total_size);
+    }
+
+    void erase(size_t start_index, const FreeBlock& block) noexcept
+    {
+      fit.erase(start_index, block.total_size);
+      stats.on_erase_free(block.total_size);
+    }
+  };
+
+  [[nodiscard]] auto hooks() noexcept -> PolicyHooks
+  {
+    return PolicyHooks{ m_fit, m_stats };
+  }
+
+  /*
+   * the bytes skipped to reach the alignment stay in the free blocks
+   */
+  auto allocate(size_t size, size_t alignment) noexcept -> void*
+  {
+    const auto found_iter = m_fit.find(m_free, origin(), size, alignment);
+
+    if (found_iter == m_free.end()) {
+      m_stats.on_fail();
+      return nullptr;
+    }
+
+    const size_t padding =
+      policy::aligned_padding(origin() + found_iter->first, alignment);
+    const size_t start_index = found_iter->first + padding;
+
+    m_free.take(found_iter, padding, size, hooks());
+
+    m_allocated.emplace(start_index, size);
+    m_stats.on_alloc(size);
+
+    void* ptr = m_data.get() + start_index;
+    Scrub::on_alloc(ptr, size);
+
+    return ptr;
+  }
+
+  void deallocate(AllocatedIndex::iterator found_iter) noexcept
+  {
+    const size_t start_index = found_iter->first;
+    const size_t size        = found_iter->second;
+
+    m_allocated.erase(found_iter);
+
+    Scrub::on_free(m_data.get() + start_index, size);
+    m_free.merge(start_index, FreeBlock{ size }, hooks());
+    m_stats.on_free(size);
+  }
+
+  /*
+   * resizes without moving, either by giving the tail back or by taking from
+   * the free block right after the allocation
+   */
+  auto resize(AllocatedIndex::iterator found_iter, size_t size) noexcept
+    -> bool
+  {
+    const size_t start_index = found_iter->first;
+    const size_t old_size    = found_iter->second;
+
+    if (size <= old_size) {
+      if (size < old_size) {
+        found_iter->second = size;
+
+        Scrub::on_free(m_data.get() + start_index + size, old_size - size);
+        m_free.merge(start_index + size, FreeBlock{ old_size - size }, hooks());
+        m_stats.on_resize(old_size, size);
+      }
+
+      return true;
+    }
+
+    const size_t grown_size = size - old_size;
+
+    if (!m_free.extend(start_index + old_size, grown_size, hooks())) {
+      return false;
+    }
+
+    found_iter->second = size;
+
+    Scrub::on_alloc(m_data.get() + start_index + old_size, grown_size);
+    m_stats.on_resize(old_size, size);
+
+    return true;
+  }
+
+  std::unique_ptr<std::byte, FreeDeleter> m_data;
+  size_t                                  m_size;
+  FreeBlocks                              m_free;
+  AllocatedIndex                          m_allocated;
+  [[no_unique_address]] Fit               m_fit;
+  [[no_unique_address]] Lock              m_lock;
+  [[no_unique_address]] Stats             m_stats;
+};
+
+} // namespace pxd::memory
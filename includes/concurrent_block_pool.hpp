@@ -0,0 +1,198 @@
+#pragma once
+
+#include "memory_pool.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace pxd::memory {
+
+/*
+ * hands out blocks of one size from a region carved out of a memory pool,
+ * without a lock. any thread may allocate and any thread may free, so a block
+ * can be allocated by a producer and freed by a consumer. the free blocks form
+ * a stack whose head holds the index of the top block and a tag which changes
+ * with every push and pop, so a pop whose top was popped and pushed again in
+ * the meantime fails its compare and swap instead of corrupting the stack.
+ * the links live beside the blocks, never inside them
+ */
+class concurrent_block_pool
+{
+public:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  /*
+   * the alignment has to be a power of two, throws std::bad_alloc if the
+   * memory pool can not hold the blocks or their byte count overflows
+   */
+  concurrent_block_pool(MemoryPool& pool,
+                        size_t      block_size,
+                        size_t      block_count,
+                        size_t      alignment = alignof(std::max_align_t))
+    : m_pool(&pool)
+    , m_stride(stride_of(block_size, alignment))
+    , m_block_count(block_count)
+  {
+    if (block_count == 0 || block_count >= EMPTY_INDEX ||
+        !std::has_single_bit(alignment) ||
+        block_count > std::numeric_limits<size_t>::max() / m_stride) {
+      throw std::bad_alloc();
+    }
+
+    m_links = std::make_unique<std::atomic<uint32_t>[]>(block_count);
+    m_data  = static_cast<std::byte*>(
+      m_pool->aligned_malloc(m_stride * block_count, alignment));
+
+    if (m_data == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    for (size_t i = 0; i < block_count; i++) {
+      m_links[i].store(i + 1 == block_count ? EMPTY_INDEX
+                                            : static_cast<uint32_t>(i + 1),
+                       std::memory_order_relaxed);
+    }
+
+    m_head.store(pack(0, 0), std::memory_order_release);
+  }
+
+  explicit concurrent_block_pool(size_t block_size, size_t block_count)
+    : concurrent_block_pool(default_pool(), block_size, block_count)
+  {
+  }
+
+  concurrent_block_pool(const concurrent_block_pool& other) = delete;
+  concurrent_block_pool& operator=(const concurrent_block_pool& other) =
+    delete;
+  concurrent_block_pool(concurrent_block_pool&& other)            = delete;
+  concurrent_block_pool& operator=(concurrent_block_pool&& other) = delete;
+
+  /*
+   * the blocks still allocated are released with the region
+   */
+  ~concurrent_block_pool() noexcept
+  {
+    m_pool->free(m_data, m_stride * m_block_count);
+  }
+
+  /*
+   * nullptr when every block is allocated
+   */
+  [[nodiscard]] auto allocate() noexcept -> void*
+  {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+
+    while (true) {
+      const uint32_t index = index_of(head);
+
+      if (index == EMPTY_INDEX) {
+        return nullptr;
+      }
+
+      /*
+       * the link may be stale when another thread popped the block first,
+       * the tag makes the compare and swap fail then
+       */
+      const uint32_t next = m_links[index].load(std::memory_order_relaxed);
+
+      if (m_head.compare_exchange_weak(head,
+                                       pack(next, tag_of(head) + 1),
+                                       std::memory_order_acquire,
+                                       std::memory_order_acquire)) {
+        return m_data + (index * m_stride);
+      }
+    }
+  }
+
+  void deallocate(void* block) noexcept
+  {
+    if (!owns(block)) {
+      return;
+    }
+
+    const auto index = static_cast<uint32_t>(
+      (static_cast<std::byte*>(block) - m_data) / m_stride);
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+
+    do {
+      m_links[index].store(index_of(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head,
+                                           pack(index, tag_of(head) + 1),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+  }
+
+  [[nodiscard]] auto owns(const void* block) const noexcept -> bool
+  {
+    const auto* bytes = static_cast<const std::byte*>(block);
+
+    return bytes >= m_data && bytes < m_data + (m_stride * m_block_count);
+  }
+
+  /*
+   * the bytes between the starts of two blocks, at least the block size
+   */
+  [[nodiscard]] auto block_size() const noexcept -> size_t { return m_stride; }
+
+  [[nodiscard]] auto block_count() const noexcept -> size_t
+  {
+    return m_block_count;
+  }
+
+private:
+  static constexpr uint32_t EMPTY_INDEX = UINT32_MAX;
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  [[nodiscard]] static auto stride_of(size_t block_size,
+                                      size_t alignment) noexcept -> size_t
+  {
+    const size_t size = block_size == 0 ? 1 : block_size;
+
+    if (alignment == 0) {
+      return size;
+    }
+
+    if (size > std::numeric_limits<size_t>::max() - (alignment - 1)) {
+      return std::numeric_limits<size_t>::max();
+    }
+
+    return ((size + alignment - 1) / alignment) * alignment;
+  }
+
+  [[nodiscard]] static constexpr auto pack(uint32_t index,
+                                           uint32_t tag) noexcept -> uint64_t
+  {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+  }
+
+  [[nodiscard]] static constexpr auto index_of(uint64_t head) noexcept
+    -> uint32_t
+  {
+    return static_cast<uint32_t>(head);
+  }
+
+  [[nodiscard]] static constexpr auto tag_of(uint64_t head) noexcept
+    -> uint32_t
+  {
+    return static_cast<uint32_t>(head >> 32);
+  }
+
+  /*
+   * the head gets a cache line of its own, it is the only contended word
+   */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_head = pack(EMPTY_INDEX, 0);
+
+  alignas(CACHE_LINE_SIZE) MemoryPool*     m_pool;
+  size_t                                   m_stride;
+  size_t                                   m_block_count;
+  std::byte*                               m_data = nullptr;
+  std::unique_ptr<std::atomic<uint32_t>[]> m_links;
+};
+
+} // namespace pxd::memory
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+
+namespace pxd::memory {
+
+/*
+ * the free blocks of a pool ordered by their start index, with the splitting
+ * and merging MemoryPool and basic_pool share. the Node kept for every block
+ * holds its total_size, its join takes in a neighbour merged into the block.
+ * the calls which change the blocks take a hooks object whose insert and
+ * erase are told about every block put into or taken out of the tree, so the
+ * pool keeps its own indices of the same blocks. the free bytes are a running
+ * total
+ */
+template<class Index, class Node>
+class free_tree
+{
+public:
+  using Blocks         = std::map<Index, Node>;
+  using iterator       = typename Blocks::iterator;
+  using const_iterator = typename Blocks::const_iterator;
+
+  [[nodiscard]] auto begin() const noexcept -> const_iterator
+  {
+    return m_blocks.begin();
+  }
+
+  [[nodiscard]] auto end() const noexcept -> const_iterator
+  {
+    return m_blocks.end();
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_blocks.empty(); }
+
+  [[nodiscard]] auto size() const noexcept -> size_t { return m_blocks.size(); }
+
+  [[nodiscard]] auto free_bytes() const noexcept -> size_t
+  {
+    return m_free_bytes;
+  }
+
+  [[nodiscard]] auto find(size_t start_index) const -> const_iterator
+  {
+    return m_blocks.find(static_cast<Index>(start_index));
+  }
+
+  [[nodiscard]] auto lower_bound(size_t start_index) const -> const_iterator
+  {
+    return m_blocks.lower_bound(static_cast<Index>(start_index));
+  }
+
+  /*
+   * the free block holding the given index, the end if it is allocated
+   */
+  [[nodiscard]] auto find_holding(size_t index) const -> const_iterator
+  {
+    auto next_iter = m_blocks.upper_bound(static_cast<Index>(index));
+
+    if (next_iter != m_blocks.begin()) {
+      auto prev_iter = std::prev(next_iter);
+
+      if (index < prev_iter->first + prev_iter->second.total_size) {
+        return prev_iter;
+      }
+    }
+
+    return m_blocks.end();
+  }
+
+  /*
+   * the hooks are not told, the pool clears its own indices
+   */
+  void clear() noexcept
+  {
+    m_blocks.clear();
+    m_free_bytes = 0;
+  }
+
+  template<class Hooks>
+  void insert(size_t start_index, const Node& node, Hooks&& hooks)
+  {
+    m_blocks.emplace(static_cast<Index>(start_index), node);
+    m_free_bytes += node.total_size;
+
+    hooks.insert(start_index, node);
+  }
+
+  template<class Hooks>
+  auto erase(const_iterator block_iter, Hooks&& hooks) -> Node
+  {
+    const size_t start_index = block_iter->first;
+    const Node   node        = block_iter->second;
+
+    hooks.erase(start_index, node);
+
+    m_blocks.erase(block_iter);
+    m_free_bytes -= node.total_size;
+
+    return node;
+  }
+
+  /*
+   * takes the given size at the given padding into the free block. the
+   * padding in front and the rest after the size stay free with the state of
+   * the block, which is returned
+   */
+  template<class Hooks>
+  auto take(const_iterator block_iter,
+            size_t         padding,
+            size_t         size,
+            Hooks&&        hooks) -> Node
+  {
+    const size_t block_index = block_iter->first;
+    const Node   node        = erase(block_iter, hooks);
+
+    if (padding > 0) {
+      insert(block_index, part_of(node, padding), hooks);
+    }
+
+    if (node.total_size > padding + size) {
+      insert(block_index + padding + size,
+             part_of(node, node.total_size - padding - size),
+             hooks);
+    }
+
+    return node;
+  }
+
+  /*
+   * inserts the free block merged with the free blocks right before and
+   * after it, returns the merged block
+   */
+  template<class Hooks>
+  auto merge(size_t start_index, Node node, Hooks&& hooks) -> const_iterator
+  {
+    auto next_iter = m_blocks.lower_bound(static_cast<Index>(start_index));
+
+    if (next_iter != m_blocks.end() &&
+        next_iter->first == start_index + node.total_size) {
+      const auto after_next = std::next(next_iter);
+
+      node.join(erase(next_iter, hooks));
+      next_iter = after_next;
+    }
+
+    if (next_iter != m_blocks.begin()) {
+      auto prev_iter = std::prev(next_iter);
+
+      if (prev_iter->first + prev_iter->second.total_size == start_index) {
+        start_index = prev_iter->first;
+
+        Node merged = erase(prev_iter, hooks);
+        merged.join(node);
+        node = merged;
+      }
+    }
+
+    insert(start_index, node, hooks);
+
+    return m_blocks.find(static_cast<Index>(start_index));
+  }
+
+  /*
+   * takes the given size from the free block which starts at the given end
+   * of an allocation, so the allocation grows without moving. false if there
+   * is no such block or it is too small
+   */
+  template<class Hooks>
+  auto extend(size_t end_index, size_t size, Hooks&& hooks) -> bool
+  {
+    const auto next_iter = find(end_index);
+
+    if (next_iter == m_blocks.end() || next_iter->second.total_size < size) {
+      return false;
+    }
+
+    take(next_iter, 0, size, hooks);
+
+    return true;
+  }
+
+private:
+  [[nodiscard]] static auto part_of(const Node& node, size_t size) noexcept
+    -> Node
+  {
+    Node part       = node;
+    part.total_size = static_cast<decltype(part.total_size)>(size);
+
+    return part;
+  }
+
+  Blocks m_blocks;
+  size_t m_free_bytes = 0;
+};
+
+} // namespace pxd::memory
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
 
 namespace pxd::memory {
 
@@ -8,43 +13,344 @@ constexpr size_t SIZE_1KB = 1024;
 constexpr size_t SIZE_1MB = static_cast<size_t>(1024) * 1024;
 constexpr size_t SIZE_1GB = static_cast<size_t>(1024) * 1024 * 1024;
 
+enum class ScrubMode : uint8_t
+{
+  NONE,
+  ZERO_ON_FREE,
+  ZERO_ON_ALLOC
+};
+
+enum class HugePages : uint8_t
+{
+  NONE,
+  TRANSPARENT,
+  EXPLICIT
+};
+
+struct PoolOptions
+{
+  /*
+   * guards the pool with a lock and serves the small sizes from per-thread
+   * caches, so malloc and free can be called from any thread
+   */
+  bool thread_safe = false;
+
+  /*
+   * when larger than the initial size, the pool reserves address space up to
+   * max_size and grows by grow_size bytes, the initial size if zero, whenever
+   * a request does not fit. returned pointers stay valid while it grows
+   */
+  size_t max_size  = 0;
+  size_t grow_size = 0;
+
+  /*
+   * gives the pages of the grow_size chunks which become completely free back
+   * to the operating system
+   */
+  bool release_free_chunks = false;
+
+  /*
+   * when the freed memory is cleared. the pool remembers which free blocks are
+   * zero, so calloc only clears the blocks which are not
+   */
+  ScrubMode scrub = ScrubMode::NONE;
+
+  /*
+   * backs the arena with huge pages to cut the tlb misses of large pools.
+   * EXPLICIT maps pages from the reserved huge page pool of the system and
+   * falls back to TRANSPARENT when there are too few, TRANSPARENT asks the
+   * kernel to merge the pages and falls back to normal pages. see backing
+   * for what was applied
+   */
+  HugePages huge_pages = HugePages::NONE;
+
+  /*
+   * faults in the committed pages up front, including the grown chunks, so
+   * the first allocations do not pay for the page faults
+   */
+  bool populate = false;
+
+  /*
+   * places the pages of the arena on the numa node, -1 leaves it to the
+   * system
+   */
+  int numa_node = -1;
+};
+
+/*
+ * what the pool applied of the backing options, those the system does not
+ * support are left out
+ */
+struct PoolBacking
+{
+  size_t    page_size  = 0;
+  HugePages huge_pages = HugePages::NONE;
+  bool      populated  = false;
+  int       numa_node  = -1;
+};
+
+/*
+ * a snapshot of the running counters of a pool. in the thread safe mode the
+ * bytes held by the thread caches count as free and the peak counts the spans
+ * of the caches as a whole. the allocated bytes are the sizes the users asked
+ * for, the guards of the hardened build count as neither allocated nor free
+ */
+struct PoolStats
+{
+  size_t allocated_bytes     = 0;
+  size_t free_bytes          = 0;
+  size_t peak_bytes          = 0;
+  size_t largest_free_block  = 0;
+  size_t smallest_free_block = 0;
+  size_t alloc_count         = 0;
+  size_t free_count          = 0;
+  size_t failed_count        = 0;
+};
+
+constexpr size_t HISTOGRAM_BUCKET_COUNT = 64;
+constexpr size_t ALIGNMENT_COUNT        = 13;
+
+/*
+ * a walk over the blocks of a pool, meant for diagnostics rather than polling.
+ * bucket i of a histogram counts the blocks of [2^i, 2^(i+1)) bytes, the
+ * spans of the thread caches count as single allocations, the allocations
+ * by their size without guards. index i of largest_aligned_block is the
+ * largest block malloc can give at an alignment of 2^i bytes
+ */
+struct PoolSnapshot
+{
+  std::array<size_t, HISTOGRAM_BUCKET_COUNT> free_histogram        = {};
+  std::array<size_t, HISTOGRAM_BUCKET_COUNT> allocated_histogram   = {};
+  std::array<size_t, ALIGNMENT_COUNT>        largest_aligned_block = {};
+
+  size_t total_free_bytes   = 0;
+  size_t largest_free_block = 0;
+
+  /*
+   * 1 - largest_free_block / total_free_bytes, zero when there is no free
+   * memory
+   */
+  double fragmentation = 0.0;
+};
+
+/*
+ * the bytes a hardened build puts before and after every allocation, they
+ * take pool memory but count as neither allocated nor free
+ */
+#if defined(PXD_HARDENED)
+constexpr size_t GUARD_SIZE = 16;
+#else
+constexpr size_t GUARD_SIZE = 0;
+#endif
+
+/*
+ * the misuses a hardened build detects, see set_corruption_handler
+ */
+enum class Corruption : uint8_t
+{
+  DOUBLE_FREE,
+  INVALID_FREE,
+  BUFFER_OVERFLOW
+};
+
+/*
+ * the pointer is the one given to free or realloc, or the first overwritten
+ * guard byte for an overflow. the block is the one the pointer falls into, as
+ * an offset into the pool and a size: the free block for a double free, the
+ * allocation for an invalid free or an overflow. an invalid free outside of
+ * any block reports an empty block
+ */
+struct CorruptionReport
+{
+  Corruption  kind        = Corruption::INVALID_FREE;
+  const void* pointer     = nullptr;
+  size_t      start_index = 0;
+  size_t      total_size  = 0;
+};
+
+using CorruptionHandler = void (*)(const CorruptionReport& report);
+
+struct Memory;
+
+/*
+ * an independent pool with its own arena, free blocks and thread caches. the
+ * free functions below work on the pool returned by default_pool
+ */
+class MemoryPool
+{
+public:
+  MemoryPool();
+  explicit MemoryPool(size_t size, const PoolOptions& options = {});
+  MemoryPool(const MemoryPool& other)            = delete;
+  MemoryPool& operator=(const MemoryPool& other) = delete;
+  MemoryPool(MemoryPool&& other)                 = delete;
+  MemoryPool& operator=(MemoryPool&& other)      = delete;
+  ~MemoryPool() noexcept;
+
+  void alloc_memory(size_t size, const PoolOptions& options = {});
+
+  [[nodiscard]] auto malloc(size_t size) noexcept -> void*;
+  [[nodiscard]] auto calloc(size_t size) noexcept -> void*;
+  [[nodiscard]] auto aligned_malloc(size_t size, size_t alignment) noexcept
+    -> void*;
+  [[nodiscard]] auto aligned_calloc(size_t size, size_t alignment) noexcept
+    -> void*;
+  [[nodiscard]] auto realloc(void* mem_pointer, size_t size) noexcept -> void*;
+
+  /*
+   * allocates size objects of T at the alignment of T, nullptr if the byte
+   * count overflows
+   */
+  template<typename T>
+  [[nodiscard]] auto easy_malloc(size_t size) noexcept -> T*
+  {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+
+    return static_cast<T*>(aligned_malloc(size * sizeof(T), alignof(T)));
+  }
+
+  template<typename T>
+  [[nodiscard]] auto easy_calloc(size_t size) noexcept -> T*
+  {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+
+    return static_cast<T*>(aligned_calloc(size * sizeof(T), alignof(T)));
+  }
+
+  void free(void* mem_pointer) noexcept;
+  void free(void* mem_pointer, size_t size) noexcept;
+
+  /*
+   * carves count blocks of size bytes out of a single free block when one is
+   * large enough, block by block otherwise. either all of them are allocated
+   * or none
+   */
+  [[nodiscard]] auto malloc_batch(size_t size,
+                                  size_t count,
+                                  void** out_ptrs) noexcept -> bool;
+
+  /*
+   * frees the pointers with one sort and one merge pass over the free blocks,
+   * the neighbouring ones are merged with each other first
+   */
+  void free_batch(void* const* ptrs, size_t count) noexcept;
+
+  /*
+   * whether the pointer lies inside the address range of the pool
+   */
+  [[nodiscard]] auto owns(const void* mem_pointer) const noexcept -> bool;
+
+  /*
+   * the bytes the allocation can use, zero if it is not allocated from the
+   * pool
+   */
+  [[nodiscard]] auto usable_size(const void* mem_pointer) noexcept -> size_t;
+
+  [[nodiscard]] auto backing() const noexcept -> PoolBacking;
+
+  void release_memory() noexcept;
+
+  /*
+   * holds the lock of the pool across a fork, so the child does not inherit it
+   * taken by a thread which only exists in the parent. prepare_fork is called
+   * right before fork, finish_fork right after it in the parent and the child,
+   * like the handlers of pthread_atfork
+   */
+  void prepare_fork() noexcept;
+  void finish_fork() noexcept;
+
+  /*
+   * the statistics are kept as running counters, none of them walks the
+   * blocks. the thread caches are summed in the thread safe mode
+   */
+  auto stats() -> PoolStats;
+  auto snapshot() -> PoolSnapshot;
+  auto total_free_memory() -> size_t;
+  auto total_allocated_memory() -> size_t;
+  auto max_free_memory() -> size_t;
+  auto min_free_memory() -> size_t;
+
+  /*
+   * the free and allocated blocks ordered by their start index as json, for
+   * offline visualization
+   */
+  auto layout_json() -> std::string;
+
+private:
+  std::unique_ptr<Memory> m_impl;
+};
+
+[[nodiscard]] auto
+default_pool() noexcept -> MemoryPool&;
+
 void
-alloc_memory(size_t size);
+alloc_memory(size_t size, const PoolOptions& options = {});
 
 [[nodiscard]] auto
 malloc(size_t size) noexcept -> void*;
 
 template<typename T>
-[[nodiscard]] auto easy_malloc(size_t size) noexcept -> T* {
-  void* ptr = malloc(size * sizeof(T));
-
-  if(ptr == nullptr) {
-    return nullptr;
-  }
-
-  return static_cast<T*>(ptr);
+[[nodiscard]] auto
+easy_malloc(size_t size) noexcept -> T*
+{
+  return default_pool().easy_malloc<T>(size);
 }
 
 [[nodiscard]] auto
 calloc(size_t size) noexcept -> void*;
 
 template<typename T>
-[[nodiscard]] auto easy_calloc(size_t size) noexcept -> T* {
-  void* ptr = calloc(size * sizeof(T));
+[[nodiscard]] auto
+easy_calloc(size_t size) noexcept -> T*
+{
+  return default_pool().easy_calloc<T>(size);
+}
 
-  if(ptr == nullptr) {
-    return nullptr;
-  }
+/*
+ * the returned pointer is a multiple of the alignment, which has to be a power
+ * of two. the bytes skipped to reach the alignment stay in the free memory
+ */
+[[nodiscard]] auto
+aligned_malloc(size_t size, size_t alignment) noexcept -> void*;
 
-  return static_cast<T*>(ptr);
-}
+[[nodiscard]] auto
+aligned_calloc(size_t size, size_t alignment) noexcept -> void*;
+
+/*
+ * grows or shrinks the allocation in place when the memory right after it
+ * allows, otherwise moves it. on failure the old allocation is left as is
+ * and nullptr is returned
+ */
+[[nodiscard]] auto
+realloc(void* mem_pointer, size_t size) noexcept -> void*;
 
 void
 free(void* mem_pointer) noexcept;
 
+/*
+ * frees with the size the block was allocated or last resized with. the size
+ * is checked against the allocation, a wrong one frees the allocation with its
+ * own size. a size of zero frees like the unsized free
+ */
+void
+free(void* mem_pointer, size_t size) noexcept;
+
+[[nodiscard]] auto
+malloc_batch(size_t size, size_t count, void** out_ptrs) noexcept -> bool;
+
+void
+free_batch(void* const* ptrs, size_t count) noexcept;
+
 void
 release_memory() noexcept;
 
+[[nodiscard]] auto
+backing() noexcept -> PoolBacking;
+
 auto
 total_free_memory() -> size_t;
 auto
@@ -53,5 +359,23 @@ auto
 max_free_memory() -> size_t;
 auto
 min_free_memory() -> size_t;
+auto
+stats() -> PoolStats;
+auto
+snapshot() -> PoolSnapshot;
+auto
+layout_json() -> std::string;
+
+/*
+ * installs the handler a hardened build calls when it detects a corruption and
+ * returns the previous one. the default handler, also restored by nullptr,
+ * prints the report and aborts. a handler which returns lets the pool go on:
+ * an invalid free is ignored, a free with a wrong size frees the allocation
+ * with its own size and an overflowed block is still freed. it runs under the
+ * lock of the pool, so it must not call into the pool
+ */
+auto
+set_corruption_handler(CorruptionHandler handler) noexcept
+  -> CorruptionHandler;
 
 } // namespace pxd::memory
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "memory_pool.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+namespace pxd::memory {
+
+/*
+ * lets the std::pmr containers allocate from a memory pool without changing
+ * their type. two resources are equal when they use the same pool
+ */
+class pool_resource : public std::pmr::memory_resource
+{
+public:
+  pool_resource() noexcept
+    : m_pool(&default_pool())
+  {
+  }
+
+  explicit pool_resource(MemoryPool& pool) noexcept
+    : m_pool(&pool)
+  {
+  }
+
+  pool_resource(const pool_resource& other)            = default;
+  pool_resource& operator=(const pool_resource& other) = default;
+  pool_resource(pool_resource&& other)                 = default;
+  pool_resource& operator=(pool_resource&& other)      = default;
+  ~pool_resource() noexcept override                   = default;
+
+  [[nodiscard]] auto pool() const noexcept -> MemoryPool* { return m_pool; }
+
+protected:
+  auto do_allocate(size_t bytes, size_t alignment) -> void* override
+  {
+    void* ptr = m_pool->aligned_malloc(bytes, alignment);
+
+    if (nullptr == ptr) {
+      throw std::bad_alloc();
+    }
+
+    return ptr;
+  }
+
+  void do_deallocate(void* ptr, size_t bytes, size_t /*alignment*/) override
+  {
+    m_pool->free(ptr, bytes);
+  }
+
+  [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other)
+    const noexcept -> bool override
+  {
+    const auto* other_pool = dynamic_cast<const pool_resource*>(&other);
+
+    return other_pool != nullptr && other_pool->m_pool == m_pool;
+  }
+
+private:
+  MemoryPool* m_pool;
+};
+
+/*
+ * the resource of the default pool, to be passed to
+ * std::pmr::set_default_resource
+ */
+[[nodiscard]] inline auto
+default_pool_resource() noexcept -> pool_resource*
+{
+  static pool_resource resource;
+
+  return &resource;
+}
+
+} // namespace pxd::memory
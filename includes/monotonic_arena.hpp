@@ -0,0 +1,221 @@
+#pragma once
+
+#include "memory_pool.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pxd::memory {
+
+/*
+ * a position of the arena to go back to, everything allocated after it is
+ * released at once
+ */
+struct ArenaMarker
+{
+  size_t chunk_index = 0;
+  size_t offset      = 0;
+};
+
+/*
+ * bumps a pointer through chunks taken from a memory pool. free is a no-op,
+ * the memory is released all at once by rewinding to a marker or resetting.
+ * the chunks are kept for the next allocations until release is called.
+ * not thread safe, use one arena per thread
+ */
+class monotonic_arena
+{
+public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * SIZE_1KB;
+
+  explicit monotonic_arena(MemoryPool& pool       = default_pool(),
+                           size_t      chunk_size = DEFAULT_CHUNK_SIZE) noexcept
+    : m_pool(&pool)
+    , m_chunk_size(chunk_size == 0 ? DEFAULT_CHUNK_SIZE : chunk_size)
+  {
+  }
+
+  monotonic_arena(const monotonic_arena& other)            = delete;
+  monotonic_arena& operator=(const monotonic_arena& other) = delete;
+  monotonic_arena(monotonic_arena&& other)                 = delete;
+  monotonic_arena& operator=(monotonic_arena&& other)      = delete;
+  ~monotonic_arena() noexcept { release(); }
+
+  /*
+   * the alignment has to be a power of two, nullptr if the memory pool is full
+   */
+  [[nodiscard]] auto allocate(size_t size,
+                              size_t alignment = alignof(std::max_align_t))
+    noexcept -> void*
+  {
+    if (size == 0 || !std::has_single_bit(alignment)) {
+      return nullptr;
+    }
+
+    for (; m_current < m_chunks.size(); m_current++, m_offset = 0) {
+      void* ptr = bump(m_chunks[m_current], size, alignment);
+
+      if (ptr != nullptr) {
+        return ptr;
+      }
+    }
+
+    if (!add_chunk(size + alignment - 1)) {
+      return nullptr;
+    }
+
+    return bump(m_chunks[m_current], size, alignment);
+  }
+
+  /*
+   * allocates size objects of T at the alignment of T, nullptr if the byte
+   * count overflows
+   */
+  template<typename T>
+  [[nodiscard]] auto easy_malloc(size_t size) noexcept -> T*
+  {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+
+    return static_cast<T*>(allocate(size * sizeof(T), alignof(T)));
+  }
+
+  void free(void* /*mem_pointer*/) noexcept {}
+
+  [[nodiscard]] auto mark() const noexcept -> ArenaMarker
+  {
+    ArenaMarker marker = {};
+    marker.chunk_index = m_current;
+    marker.offset      = m_offset;
+
+    return marker;
+  }
+
+  /*
+   * releases everything allocated after the marker was taken
+   */
+  void rewind(const ArenaMarker& marker) noexcept
+  {
+    m_current = marker.chunk_index;
+    m_offset  = marker.offset;
+  }
+
+  /*
+   * releases everything, the chunks stay for the next allocations
+   */
+  void reset() noexcept { rewind({}); }
+
+  /*
+   * releases everything and gives the chunks back to the memory pool
+   */
+  void release() noexcept
+  {
+    for (const Chunk& chunk : m_chunks) {
+      m_pool->free(chunk.data, chunk.size);
+    }
+
+    m_chunks.clear();
+    m_current = 0;
+    m_offset  = 0;
+  }
+
+  [[nodiscard]] auto used_memory() const noexcept -> size_t
+  {
+    size_t used = m_offset;
+
+    for (size_t i = 0; i < m_current && i < m_chunks.size(); i++) {
+      used += m_chunks[i].size;
+    }
+
+    return used;
+  }
+
+  [[nodiscard]] auto chunk_count() const noexcept -> size_t
+  {
+    return m_chunks.size();
+  }
+
+private:
+  struct Chunk
+  {
+    uint8_t* data = nullptr;
+    size_t   size = 0;
+  };
+
+  auto bump(const Chunk& chunk, size_t size, size_t alignment) noexcept
+    -> void*
+  {
+    const auto   address = reinterpret_cast<uintptr_t>(chunk.data) + m_offset;
+    const size_t padding = (alignment - (address % alignment)) % alignment;
+
+    if (m_offset + padding + size > chunk.size) {
+      return nullptr;
+    }
+
+    void* ptr = chunk.data + m_offset + padding;
+    m_offset += padding + size;
+
+    return ptr;
+  }
+
+  /*
+   * the new chunk goes after the ones in use, a request larger than the chunk
+   * size gets a chunk of its own size
+   */
+  auto add_chunk(size_t min_size) noexcept -> bool
+  {
+    Chunk chunk = {};
+    chunk.size  = min_size > m_chunk_size ? min_size : m_chunk_size;
+    chunk.data  = static_cast<uint8_t*>(m_pool->malloc(chunk.size));
+
+    if (chunk.data == nullptr) {
+      return false;
+    }
+
+    try {
+      m_chunks.push_back(chunk);
+    } catch (...) {
+      m_pool->free(chunk.data, chunk.size);
+      return false;
+    }
+
+    m_current = m_chunks.size() - 1;
+    m_offset  = 0;
+
+    return true;
+  }
+
+  MemoryPool*        m_pool;
+  size_t             m_chunk_size;
+  std::vector<Chunk> m_chunks;
+  size_t             m_current = 0;
+  size_t             m_offset  = 0;
+};
+
+/*
+ * rewinds the arena to where it was when the scope started
+ */
+class arena_scope
+{
+public:
+  explicit arena_scope(monotonic_arena& arena) noexcept
+    : m_arena(&arena)
+    , m_marker(arena.mark())
+  {
+  }
+
+  arena_scope(const arena_scope& other)            = delete;
+  arena_scope& operator=(const arena_scope& other) = delete;
+  arena_scope(arena_scope&& other)                 = delete;
+  arena_scope& operator=(arena_scope&& other)      = delete;
+  ~arena_scope() noexcept { m_arena->rewind(m_marker); }
+
+private:
+  monotonic_arena* m_arena;
+  ArenaMarker      m_marker;
+};
+
+} // namespace pxd::memory
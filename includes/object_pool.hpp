@@ -0,0 +1,345 @@
+#pragma once
+
+#include "memory_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pxd::memory {
+
+/*
+ * hands out blocks of sizeof(T) from slabs carved out of a memory pool. a free
+ * block keeps the link to the next free block in itself, so there is no per
+ * object bookkeeping and allocate and free are a few instructions each. the
+ * slabs go back to the memory pool only when the object pool is destroyed.
+ * not thread safe, use one object pool per thread
+ */
+template<class T>
+class object_pool
+{
+public:
+  static constexpr size_t SLOT_ALIGNMENT =
+    std::max(alignof(T), alignof(void*));
+  static constexpr size_t SLOT_SIZE =
+    ((std::max(sizeof(T), sizeof(void*)) + SLOT_ALIGNMENT - 1) /
+     SLOT_ALIGNMENT) *
+    SLOT_ALIGNMENT;
+
+  /*
+   * the slabs hold about a page of objects when the count is zero
+   */
+  explicit object_pool(MemoryPool& pool            = default_pool(),
+                       size_t      objects_per_slab = 0) noexcept
+    : m_pool(&pool)
+    , m_objects_per_slab(objects_per_slab == 0
+                           ? std::max<size_t>(4 * SIZE_1KB / SLOT_SIZE, 8)
+                           : objects_per_slab)
+  {
+  }
+
+  object_pool(const object_pool& other)            = delete;
+  object_pool& operator=(const object_pool& other) = delete;
+  object_pool(object_pool&& other)                 = delete;
+  object_pool& operator=(object_pool&& other)      = delete;
+  ~object_pool() noexcept { release(); }
+
+  /*
+   * uninitialized storage for one object, nullptr if the memory pool is full
+   */
+  [[nodiscard]] auto allocate() noexcept -> T*
+  {
+    if (m_free_list != nullptr) {
+      FreeSlot* slot = m_free_list;
+      m_free_list    = slot->next;
+
+      return reinterpret_cast<T*>(slot);
+    }
+
+    if (m_bump == m_bump_end && !add_slab()) {
+      return nullptr;
+    }
+
+    std::byte* slot = m_bump;
+    m_bump         += SLOT_SIZE;
+
+    return reinterpret_cast<T*>(slot);
+  }
+
+  void deallocate(T* object) noexcept
+  {
+    if (object == nullptr) {
+      return;
+    }
+
+    auto* slot  = ::new (static_cast<void*>(object)) FreeSlot();
+    slot->next  = m_free_list;
+    m_free_list = slot;
+  }
+
+  template<class... Args>
+  [[nodiscard]] auto create(Args&&... args) -> T*
+  {
+    T* object = allocate();
+
+    if (object == nullptr) {
+      return nullptr;
+    }
+
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      return ::new (static_cast<void*>(object)) T(std::forward<Args>(args)...);
+    }
+    else {
+      try {
+        return ::new (static_cast<void*>(object))
+          T(std::forward<Args>(args)...);
+      } catch (...) {
+        deallocate(object);
+        throw;
+      }
+    }
+  }
+
+  void destroy(T* object) noexcept
+  {
+    if (object == nullptr) {
+      return;
+    }
+
+    object->~T();
+    deallocate(object);
+  }
+
+  /*
+   * gives every slab back to the memory pool, the objects still alive are not
+   * destroyed
+   */
+  void release() noexcept
+  {
+    for (void* slab : m_slabs) {
+      m_pool->free(slab, m_objects_per_slab * SLOT_SIZE);
+    }
+
+    m_slabs.clear();
+    m_free_list = nullptr;
+    m_bump      = nullptr;
+    m_bump_end  = nullptr;
+  }
+
+  [[nodiscard]] auto pool() const noexcept -> MemoryPool* { return m_pool; }
+
+  [[nodiscard]] auto slab_count() const noexcept -> size_t
+  {
+    return m_slabs.size();
+  }
+
+private:
+  struct FreeSlot
+  {
+    FreeSlot* next = nullptr;
+  };
+
+  auto add_slab() noexcept -> bool
+  {
+    const size_t slab_size = m_objects_per_slab * SLOT_SIZE;
+
+    auto* slab = static_cast<std::byte*>(
+      m_pool->aligned_malloc(slab_size, SLOT_ALIGNMENT));
+
+    if (slab == nullptr) {
+      return false;
+    }
+
+    try {
+      m_slabs.push_back(slab);
+    } catch (...) {
+      m_pool->free(slab, slab_size);
+      return false;
+    }
+
+    m_bump     = slab;
+    m_bump_end = slab + slab_size;
+
+    return true;
+  }
+
+  MemoryPool*        m_pool;
+  size_t             m_objects_per_slab;
+  std::vector<void*> m_slabs;
+  FreeSlot*          m_free_list = nullptr;
+  std::byte*         m_bump      = nullptr;
+  std::byte*         m_bump_end  = nullptr;
+};
+
+/*
+ * the object pools of an allocator and all of its rebound copies, one per
+ * value type. the pools are created on first use and live as long as the
+ * last allocator of the family
+ */
+class object_pool_family
+{
+public:
+  explicit object_pool_family(MemoryPool& pool) noexcept
+    : m_pool(&pool)
+  {
+  }
+
+  object_pool_family(const object_pool_family& other)            = delete;
+  object_pool_family& operator=(const object_pool_family& other) = delete;
+  object_pool_family(object_pool_family&& other)                 = delete;
+  object_pool_family& operator=(object_pool_family&& other)      = delete;
+  ~object_pool_family() noexcept                                 = default;
+
+  template<class T>
+  [[nodiscard]] auto objects() -> object_pool<T>&
+  {
+    std::shared_ptr<void>& objects = m_objects[&TYPE_KEY<T>];
+
+    if (objects == nullptr) {
+      objects = std::make_shared<object_pool<T>>(*m_pool);
+    }
+
+    return *static_cast<object_pool<T>*>(objects.get());
+  }
+
+  [[nodiscard]] auto pool() const noexcept -> MemoryPool* { return m_pool; }
+
+private:
+  /*
+   * a distinct address per type, so the pools are found without rtti
+   */
+  template<class T>
+  static constexpr char TYPE_KEY = 0;
+
+  MemoryPool*                                           m_pool;
+  std::unordered_map<const void*, std::shared_ptr<void>> m_objects;
+};
+
+/*
+ * allocates the single objects of node based containers, like std::list and
+ * std::map, from an object pool and larger arrays from the memory pool. all
+ * copies and rebound copies of an allocator share one object pool family and
+ * compare equal, so a container allocating its nodes through a rebound copy
+ * frees them into the same object pool
+ */
+template<class T>
+struct object_allocator
+{
+  using value_type                             = T;
+  using size_type                              = std::size_t;
+  using difference_type                        = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap            = std::true_type;
+  using is_always_equal                        = std::false_type;
+
+  object_allocator()
+    : object_allocator(default_pool())
+  {
+  }
+
+  explicit object_allocator(MemoryPool& pool)
+    : m_family(std::make_shared<object_pool_family>(pool))
+  {
+  }
+
+  template<class U>
+  object_allocator(const object_allocator<U>& other) noexcept
+    : m_family(other.family())
+  {
+  }
+
+  /*
+   * a moved from container can still allocate, so moving shares the family
+   * like copying does
+   */
+  object_allocator(const object_allocator& other)            = default;
+  object_allocator& operator=(const object_allocator& other) = default;
+  object_allocator(object_allocator&& other) noexcept
+    : m_family(other.m_family)
+    , m_objects(other.m_objects)
+  {
+  }
+  object_allocator& operator=(object_allocator&& other) noexcept
+  {
+    m_family  = other.m_family;
+    m_objects = other.m_objects;
+    return *this;
+  }
+  ~object_allocator() noexcept = default;
+
+  auto allocate(size_type n) -> T*
+  {
+    void* ptr = nullptr;
+
+    if (n == 1) {
+      ptr = objects().allocate();
+    }
+    else if ((std::numeric_limits<size_type>::max() / sizeof(T)) < n) {
+      throw std::bad_array_new_length();
+    }
+    else {
+      ptr = pool()->aligned_malloc(n * sizeof(T), alignof(T));
+    }
+
+    if (nullptr == ptr) {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* p, size_type n) noexcept
+  {
+    if (n == 1) {
+      objects().deallocate(p);
+    }
+    else {
+      pool()->free(p, n * sizeof(T));
+    }
+  }
+
+  [[nodiscard]] auto pool() const noexcept -> MemoryPool*
+  {
+    return m_family->pool();
+  }
+
+  [[nodiscard]] auto family() const noexcept
+    -> const std::shared_ptr<object_pool_family>&
+  {
+    return m_family;
+  }
+
+  /*
+   * the object pool of T in the family, created on the first call. it exists
+   * already for any object this allocator or an equal one handed out, so
+   * deallocate never creates it
+   */
+  [[nodiscard]] auto objects() -> object_pool<T>&
+  {
+    if (m_objects == nullptr) {
+      m_objects = &m_family->objects<T>();
+    }
+
+    return *m_objects;
+  }
+
+private:
+  std::shared_ptr<object_pool_family> m_family;
+  object_pool<T>*                     m_objects = nullptr;
+};
+
+template<class T, class U>
+auto
+operator==(const object_allocator<T>& lhs,
+           const object_allocator<U>& rhs) noexcept -> bool
+{
+  return lhs.family() == rhs.family();
+}
+
+} // namespace pxd::memory
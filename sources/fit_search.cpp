@@ -0,0 +1,191 @@
+#include "../includes/basic_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PXD_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+/*
+ * the kernels are compiled for their instruction set with target attributes
+ * instead of global flags, so the binary still runs on cpus without them and
+ * picks the kernel at runtime. other compilers and cpus use the scalar search
+ */
+
+namespace pxd::memory {
+
+namespace {
+
+using FindFunction = size_t (*)(const size_t*, size_t, size_t) noexcept;
+
+[[nodiscard]] auto
+find_scalar(const size_t* sizes, size_t count, size_t size) noexcept -> size_t
+{
+  for (size_t i = 0; i < count; i++) {
+    if (sizes[i] >= size) {
+      return i;
+    }
+  }
+
+  return count;
+}
+
+#if defined(PXD_X86_DISPATCH)
+
+static_assert(sizeof(size_t) == sizeof(uint64_t));
+
+/*
+ * there is no unsigned 64 bit compare before avx-512, flipping the sign bits
+ * of both sides turns the signed compare into one
+ */
+constexpr auto SIGN_BIT = static_cast<long long>(uint64_t{ 1 } << 63);
+
+__attribute__((target("sse4.2"))) auto
+find_sse4_2(const size_t* sizes, size_t count, size_t size) noexcept -> size_t
+{
+  const __m128i sign   = _mm_set1_epi64x(SIGN_BIT);
+  const __m128i needle = _mm_xor_si128(
+    _mm_set1_epi64x(static_cast<long long>(size)), sign);
+
+  size_t i = 0;
+
+  for (; i + 2 <= count; i += 2) {
+    const __m128i values = _mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(sizes + i)), sign);
+    const auto too_small = static_cast<unsigned>(
+      _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(needle, values))));
+
+    if (too_small != 0x3) {
+      return i + static_cast<size_t>(std::countr_one(too_small));
+    }
+  }
+
+  return i + find_scalar(sizes + i, count - i, size);
+}
+
+__attribute__((target("avx2"))) auto
+find_avx2(const size_t* sizes, size_t count, size_t size) noexcept -> size_t
+{
+  const __m256i sign   = _mm256_set1_epi64x(SIGN_BIT);
+  const __m256i needle = _mm256_xor_si256(
+    _mm256_set1_epi64x(static_cast<long long>(size)), sign);
+
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    const __m256i values = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sizes + i)), sign);
+    const auto too_small = static_cast<unsigned>(_mm256_movemask_pd(
+      _mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, values))));
+
+    if (too_small != 0xF) {
+      return i + static_cast<size_t>(std::countr_one(too_small));
+    }
+  }
+
+  return i + find_scalar(sizes + i, count - i, size);
+}
+
+/*
+ * the tail is read with a masked load, so no scalar loop is needed
+ */
+__attribute__((target("avx512f"))) auto
+find_avx512(const size_t* sizes, size_t count, size_t size) noexcept -> size_t
+{
+  const __m512i needle = _mm512_set1_epi64(static_cast<long long>(size));
+
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    const auto fits = static_cast<unsigned>(
+      _mm512_cmpge_epu64_mask(_mm512_loadu_si512(sizes + i), needle));
+
+    if (fits != 0) {
+      return i + static_cast<size_t>(std::countr_zero(fits));
+    }
+  }
+
+  const auto    lanes  = static_cast<__mmask8>((1U << (count - i)) - 1);
+  const __m512i values = _mm512_maskz_loadu_epi64(lanes, sizes + i);
+  const auto    fits   = static_cast<unsigned>(
+    _mm512_mask_cmpge_epu64_mask(lanes, values, needle));
+
+  return fits != 0 ? i + static_cast<size_t>(std::countr_zero(fits)) : count;
+}
+
+#endif
+
+[[nodiscard]] auto
+detect_simd_level() noexcept -> SimdLevel
+{
+#if defined(PXD_X86_DISPATCH)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::AVX512;
+  }
+
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::SSE4_2;
+  }
+#endif
+
+  return SimdLevel::SCALAR;
+}
+
+[[nodiscard]] auto
+kernel_of(SimdLevel level) noexcept -> FindFunction
+{
+#if defined(PXD_X86_DISPATCH)
+  switch (level) {
+    case SimdLevel::AVX512:
+      return find_avx512;
+    case SimdLevel::AVX2:
+      return find_avx2;
+    case SimdLevel::SSE4_2:
+      return find_sse4_2;
+    case SimdLevel::SCALAR:
+      break;
+  }
+#endif
+
+  return find_scalar;
+}
+
+} // namespace
+
+auto
+simd_level() noexcept -> SimdLevel
+{
+  static const SimdLevel level = detect_simd_level();
+
+  return level;
+}
+
+auto
+find_first_at_least(const size_t* sizes, size_t count, size_t size) noexcept
+  -> size_t
+{
+  static const FindFunction kernel = kernel_of(simd_level());
+
+  return kernel(sizes, count, size);
+}
+
+auto
+find_first_at_least(const size_t* sizes,
+                    size_t        count,
+                    size_t        size,
+                    SimdLevel     level) noexcept -> size_t
+{
+  return kernel_of(std::min(level, simd_level()))(sizes, count, size);
+}
+
+} // namespace pxd::memory
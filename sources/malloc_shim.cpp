@@ -0,0 +1,346 @@
+#include "../includes/memory_pool.hpp"
+#include "pool_hooks.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <new>
+#include <pthread.h>
+
+/*
+ * exports the malloc family of libc on top of the default pool, so binaries
+ * get the pool through LD_PRELOAD without being rebuilt. the pool is created
+ * by the first allocation with the sizes in the environment:
+ *
+ *   PXD_POOL_SIZE      initial size in bytes, 256 MB by default
+ *   PXD_POOL_MAX_SIZE  size the pool may grow to, no growth by default
+ *
+ * while the pool is being created, when it is full and for the allocations
+ * the pool makes for its own bookkeeping, the libc allocator is used. frees
+ * are routed by checking whether the pointer lies inside the pool
+ */
+
+extern "C" {
+auto
+__libc_malloc(size_t size) -> void*;
+auto
+__libc_calloc(size_t count, size_t size) -> void*;
+auto
+__libc_realloc(void* mem_pointer, size_t size) -> void*;
+auto
+__libc_memalign(size_t alignment, size_t size) -> void*;
+void
+__libc_free(void* mem_pointer);
+}
+
+namespace {
+
+constexpr size_t DEFAULT_POOL_SIZE = 256 * pxd::memory::SIZE_1MB;
+constexpr size_t MALLOC_ALIGNMENT  = alignof(std::max_align_t);
+
+enum class ShimState : uint8_t
+{
+  UNINITIALIZED,
+  INITIALIZING,
+  READY,
+  FAILED
+};
+
+std::atomic<ShimState> g_state = ShimState::UNINITIALIZED;
+
+/*
+ * getenv does not allocate, strtoull neither
+ */
+[[nodiscard]] auto
+env_size(const char* name, size_t default_size) noexcept -> size_t
+{
+  const char* value = std::getenv(name);
+
+  if (value == nullptr || *value == '\0') {
+    return default_size;
+  }
+
+  return static_cast<size_t>(std::strtoull(value, nullptr, 10));
+}
+
+/*
+ * a fork while another thread holds the lock of the pool would leave the
+ * child with a lock nobody releases, so the lock is taken across the fork
+ */
+bool g_fork_locked = false;
+
+void
+prepare_fork() noexcept
+{
+  if (g_state.load(std::memory_order_acquire) == ShimState::READY) {
+    pxd::memory::default_pool().prepare_fork();
+    g_fork_locked = true;
+  }
+}
+
+void
+finish_fork() noexcept
+{
+  if (g_fork_locked) {
+    g_fork_locked = false;
+    pxd::memory::default_pool().finish_fork();
+  }
+}
+
+/*
+ * the pool if it is ready, nullptr while it is created or if it failed. the
+ * first caller creates it, the others use libc meanwhile
+ */
+[[nodiscard]] auto
+shim_pool() noexcept -> pxd::memory::MemoryPool*
+{
+  if (pxd::memory::hooks::in_pool_call()) {
+    return nullptr;
+  }
+
+  ShimState state = g_state.load(std::memory_order_acquire);
+
+  if (state == ShimState::READY) {
+    return &pxd::memory::default_pool();
+  }
+
+  if (state != ShimState::UNINITIALIZED ||
+      !g_state.compare_exchange_strong(state,
+                                       ShimState::INITIALIZING,
+                                       std::memory_order_acq_rel)) {
+    return nullptr;
+  }
+
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+  options.max_size                 = env_size("PXD_POOL_MAX_SIZE", 0);
+
+  try {
+    pxd::memory::default_pool().alloc_memory(
+      env_size("PXD_POOL_SIZE", DEFAULT_POOL_SIZE), options);
+  } catch (...) {
+    g_state.store(ShimState::FAILED, std::memory_order_release);
+    return nullptr;
+  }
+
+  /*
+   * pthread_atfork may allocate, which goes to libc while initializing
+   */
+  if (pthread_atfork(prepare_fork, finish_fork, finish_fork) != 0) {
+    pxd::memory::default_pool().release_memory();
+    g_state.store(ShimState::FAILED, std::memory_order_release);
+    return nullptr;
+  }
+
+  g_state.store(ShimState::READY, std::memory_order_release);
+
+  return &pxd::memory::default_pool();
+}
+
+/*
+ * the pool which owns the pointer, nullptr for the pointers of libc
+ */
+[[nodiscard]] auto
+owner_pool(const void* mem_pointer) noexcept -> pxd::memory::MemoryPool*
+{
+  if (mem_pointer == nullptr ||
+      g_state.load(std::memory_order_acquire) != ShimState::READY) {
+    return nullptr;
+  }
+
+  pxd::memory::MemoryPool& pool = pxd::memory::default_pool();
+
+  return pool.owns(mem_pointer) ? &pool : nullptr;
+}
+
+[[nodiscard]] auto
+is_valid_alignment(size_t alignment) noexcept -> bool
+{
+  return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+[[nodiscard]] auto
+shim_aligned_malloc(size_t alignment, size_t size) noexcept -> void*
+{
+  pxd::memory::MemoryPool* pool = shim_pool();
+
+  if (pool != nullptr) {
+    void* ptr = pool->aligned_malloc(size, alignment);
+
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
+  return alignment <= MALLOC_ALIGNMENT ? __libc_malloc(size)
+                                       : __libc_memalign(alignment, size);
+}
+
+using UsableSizeFunction = size_t (*)(void*);
+
+/*
+ * the malloc_usable_size of libc, looked up on first use
+ */
+[[nodiscard]] auto
+libc_usable_size() noexcept -> UsableSizeFunction
+{
+  static std::atomic<UsableSizeFunction> function = nullptr;
+
+  UsableSizeFunction found = function.load(std::memory_order_acquire);
+
+  if (found == nullptr) {
+    found = reinterpret_cast<UsableSizeFunction>(
+      dlsym(RTLD_NEXT, "malloc_usable_size"));
+    function.store(found, std::memory_order_release);
+  }
+
+  return found;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// -- Exported Functions
+
+extern "C" {
+
+__attribute__((visibility("default"))) auto
+malloc(size_t size) -> void*
+{
+  return shim_aligned_malloc(MALLOC_ALIGNMENT, size);
+}
+
+__attribute__((visibility("default"))) void
+free(void* mem_pointer)
+{
+  if (mem_pointer == nullptr) {
+    return;
+  }
+
+  pxd::memory::MemoryPool* pool = owner_pool(mem_pointer);
+
+  if (pool != nullptr) {
+    pool->free(mem_pointer);
+    return;
+  }
+
+  __libc_free(mem_pointer);
+}
+
+__attribute__((visibility("default"))) auto
+calloc(size_t count, size_t size) -> void*
+{
+  if (size != 0 && count > SIZE_MAX / size) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+
+  const size_t total_size = count * size;
+
+  pxd::memory::MemoryPool* pool = shim_pool();
+
+  if (pool != nullptr) {
+    void* ptr = pool->aligned_calloc(total_size, MALLOC_ALIGNMENT);
+
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
+  return __libc_calloc(1, total_size);
+}
+
+__attribute__((visibility("default"))) auto
+realloc(void* mem_pointer, size_t size) -> void*
+{
+  if (mem_pointer == nullptr) {
+    return malloc(size);
+  }
+
+  pxd::memory::MemoryPool* pool = owner_pool(mem_pointer);
+
+  if (pool == nullptr) {
+    return __libc_realloc(mem_pointer, size);
+  }
+
+  if (size == 0) {
+    pool->free(mem_pointer);
+    return nullptr;
+  }
+
+  void* moved = pool->realloc(mem_pointer, size);
+
+  if (moved != nullptr) {
+    return moved;
+  }
+
+  /*
+   * the pool is full, the block moves to libc
+   */
+  const size_t old_size = pool->usable_size(mem_pointer);
+
+  moved = __libc_malloc(size);
+
+  if (moved == nullptr) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+
+  std::memcpy(moved, mem_pointer, old_size < size ? old_size : size);
+  pool->free(mem_pointer);
+
+  return moved;
+}
+
+__attribute__((visibility("default"))) auto
+posix_memalign(void** mem_pointer, size_t alignment, size_t size) -> int
+{
+  if (!is_valid_alignment(alignment) || alignment % sizeof(void*) != 0) {
+    return EINVAL;
+  }
+
+  void* ptr = shim_aligned_malloc(alignment, size);
+
+  if (ptr == nullptr) {
+    return ENOMEM;
+  }
+
+  *mem_pointer = ptr;
+
+  return 0;
+}
+
+__attribute__((visibility("default"))) auto
+aligned_alloc(size_t alignment, size_t size) -> void*
+{
+  if (!is_valid_alignment(alignment)) {
+    errno = EINVAL;
+    return nullptr;
+  }
+
+  return shim_aligned_malloc(alignment, size);
+}
+
+__attribute__((visibility("default"))) auto
+malloc_usable_size(void* mem_pointer) -> size_t
+{
+  if (mem_pointer == nullptr) {
+    return 0;
+  }
+
+  pxd::memory::MemoryPool* pool = owner_pool(mem_pointer);
+
+  if (pool != nullptr) {
+    return pool->usable_size(mem_pointer);
+  }
+
+  UsableSizeFunction function = libc_usable_size();
+
+  return function == nullptr ? 0 : function(mem_pointer);
+}
+
+} // extern "C"
@@ -1,11 +1,41 @@
 #include "../includes/memory_pool.hpp"
+#include "../includes/free_tree.hpp"
+#include "os_memory.hpp"
+#include "pool_hooks.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#if defined(__SANITIZE_ADDRESS__)
+#define PXD_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define PXD_ASAN 1
+#endif
+#endif
+
+#if defined(PXD_ASAN)
+#include <sanitizer/asan_interface.h>
+#endif
+
 namespace pxd::memory {
 
 struct MemoryInfo
@@ -21,18 +51,6 @@ struct MemoryInfo
   ~MemoryInfo() noexcept                         = default;
 
   [[nodiscard]] auto empty() const noexcept -> bool { return total_size == 0; }
-
-  [[nodiscard]] auto is_prev_from_given(const MemoryInfo& other) const noexcept
-    -> bool
-  {
-    return (start_index + total_size) == other.start_index;
-  }
-
-  [[nodiscard]] auto is_next_from_given(const MemoryInfo& other) const noexcept
-    -> bool
-  {
-    return (other.start_index + other.total_size) == start_index;
-  }
 };
 
 constexpr bool
@@ -47,307 +65,2355 @@ operator!=(const MemoryInfo& lhs, const MemoryInfo& rhs)
   return lhs.start_index != rhs.start_index || lhs.total_size != rhs.total_size;
 }
 
+/*
+ * free blocks are kept in power-of-two size classes, bin k holds the blocks
+ * with a size in [2^k, 2^(k+1)). every bin is ordered by size so the best fit
+ * inside a bin is a single lower_bound and the bitmap gives the next non-empty
+ * bin without touching the empty ones.
+ */
+constexpr size_t BIN_COUNT = std::numeric_limits<size_t>::digits;
+
+struct SizeOrder
+{
+  constexpr auto operator()(const MemoryInfo& lhs,
+                            const MemoryInfo& rhs) const noexcept -> bool
+  {
+    if (lhs.total_size != rhs.total_size) {
+      return lhs.total_size < rhs.total_size;
+    }
+
+    return lhs.start_index < rhs.start_index;
+  }
+};
+
+using FreeBin = std::set<MemoryInfo, SizeOrder>;
+
+/*
+ * the same free blocks ordered by their start index. neighbours of a block are
+ * found with a single lower_bound. a block is known to be zero if it was never
+ * handed out or if it was scrubbed when freed, calloc skips its memset then
+ */
+struct FreeNode
+{
+  size_t total_size = 0;
+  bool   is_zero    = false;
+
+  void join(const FreeNode& other) noexcept
+  {
+    total_size += other.total_size;
+    is_zero     = is_zero && other.is_zero;
+  }
+};
+
+using FreeTree = free_tree<size_t, FreeNode>;
+
+/*
+ * the start index of an allocated block and whether its bytes are all zero
+ */
+struct Allocation
+{
+  size_t start_index = std::numeric_limits<size_t>::max();
+  bool   is_zero     = false;
+};
+
+/*
+ * live allocations are indexed by their start index, the value is the size of
+ * the allocation. free finds its block with a single hash lookup
+ */
+using AllocatedIndex = std::unordered_map<size_t, size_t>;
+
+/*
+ * in the thread safe mode the small sizes are served from per-thread caches.
+ * a cache takes CACHE_SPAN_SIZE bytes from the shared pool at a time and
+ * dedicates them to one size class. spans start at a multiple of their size
+ * so the span, and with it the owning cache, of any pointer is found with a
+ * single division. blocks freed by a thread other than the owner are pushed to
+ * the lock-free remote free stack of the owner and picked up by the owner on
+ * its next allocation of that size. a span whose blocks are all free again goes
+ * back to the shared pool, except the one its class bumps from, which is only
+ * given back when the shared pool runs out.
+ */
+constexpr size_t CACHE_GRANULE     = 16;
+constexpr size_t CACHE_MAX_SIZE    = 256;
+constexpr size_t CACHE_CLASS_COUNT = CACHE_MAX_SIZE / CACHE_GRANULE;
+constexpr size_t CACHE_SPAN_SIZE   = 64 * SIZE_1KB;
+constexpr size_t INVALID_INDEX     = std::numeric_limits<size_t>::max();
+
+struct ThreadCache;
+
+struct CacheNode
+{
+  CacheNode* next = nullptr;
+};
+
+/*
+ * the live count is the number of blocks handed out and not yet back in the
+ * owner's free lists, only the owner thread changes it
+ */
+struct CacheSpan
+{
+  ThreadCache* owner       = nullptr;
+  size_t       block_size  = 0;
+  size_t       start_index = 0;
+  size_t       live_count  = 0;
+};
+
+struct CacheClass
+{
+  CacheNode* free_list    = nullptr;
+  CacheSpan* bump_span    = nullptr;
+  size_t     bump_index   = 0;
+  size_t     bump_end     = 0;
+  bool       bump_is_zero = false;
+};
+
+struct ThreadCache
+{
+  std::array<CacheClass, CACHE_CLASS_COUNT> m_classes;
+  std::vector<std::unique_ptr<CacheSpan>>   m_spans;
+  std::atomic<CacheNode*>                   m_remote_frees = nullptr;
+  std::atomic<size_t>                       m_cached_bytes = 0;
+  std::atomic<size_t>                       m_remote_bytes = 0;
+  std::atomic<size_t>                       m_alloc_count  = 0;
+  std::atomic<size_t>                       m_free_count   = 0;
+  std::atomic<size_t>                       m_remote_count = 0;
+  std::atomic<bool>                         m_in_use       = false;
+  std::atomic<bool>                         m_pool_alive   = true;
+  std::atomic<std::thread::id>              m_owner;
+};
+
+using SpanTable = std::unique_ptr<std::atomic<CacheSpan*>[]>;
+
+/*
+ * the arena is reserved from the operating system and only committed, so its
+ * pages are not touched until they are used. a growable pool reserves the
+ * address space for its largest size up front and commits it chunk by chunk,
+ * so the pool grows without moving and the free blocks of neighbouring chunks
+ * merge like any other free blocks
+ */
 struct Memory
 {
-  std::vector<uint8_t>    m_memory;
-  std::vector<MemoryInfo> m_freed;
-  std::vector<MemoryInfo> m_allocated;
+  uint8_t*  m_data  = nullptr;
+  size_t    m_size  = 0;
+  ScrubMode m_scrub = ScrubMode::NONE;
+
+  bool                 m_growable       = false;
+  size_t               m_reserved_size  = 0;
+  size_t               m_committed_size = 0;
+  size_t               m_chunk_size     = 0;
+  bool                 m_release_chunks = false;
+  std::vector<uint8_t> m_resident_chunks;
+  PoolBacking          m_backing;
+
+  std::array<FreeBin, BIN_COUNT> m_bins;
+  uint64_t                       m_bin_map = 0;
+  FreeTree                       m_free_tree;
+  AllocatedIndex                 m_allocated;
+
+  /*
+   * running totals of the allocation index, the free tree keeps the one of the
+   * free blocks, so the statistics do not walk them. the counts of the thread
+   * caches are kept by the caches
+   */
+  size_t              m_allocated_bytes = 0;
+  size_t              m_peak_bytes      = 0;
+  size_t              m_alloc_count     = 0;
+  size_t              m_free_count      = 0;
+  std::atomic<size_t> m_failed_count    = 0;
+
+  std::mutex                                m_mutex;
+  bool                                      m_thread_safe = false;
+  SpanTable                                 m_span_table;
+  std::vector<std::shared_ptr<ThreadCache>> m_caches;
+};
+
+/*
+ * the lock is only taken in the thread safe mode
+ */
+[[nodiscard]] auto
+lock_memory(Memory& memory) -> std::unique_lock<std::mutex>
+{
+  if (memory.m_thread_safe) {
+    return std::unique_lock<std::mutex>(memory.m_mutex);
+  }
+
+  return {};
+}
+
+[[nodiscard]] constexpr auto
+bin_index(size_t size) noexcept -> size_t
+{
+  return static_cast<size_t>(std::bit_width(size)) - 1;
+}
+
+// -----------------------------------------------------------------------------
+// -- Pool Calls
+
+thread_local bool t_in_pool_call = false;
+
+/*
+ * marks the calling thread as running inside a pool until the end of the
+ * scope, see hooks::in_pool_call
+ */
+class PoolCall
+{
+public:
+  PoolCall() noexcept
+    : m_outer(t_in_pool_call)
+  {
+    t_in_pool_call = true;
+  }
+
+  PoolCall(const PoolCall& other)            = delete;
+  PoolCall& operator=(const PoolCall& other) = delete;
+  PoolCall(PoolCall&& other)                 = delete;
+  PoolCall& operator=(PoolCall&& other)      = delete;
+  ~PoolCall() noexcept { t_in_pool_call = m_outer; }
+
+private:
+  bool m_outer;
 };
 
-static Memory memory;
+[[nodiscard]] auto
+make_memory() -> std::unique_ptr<Memory>
+{
+  const PoolCall call;
+
+  return std::make_unique<Memory>();
+}
+
+// -----------------------------------------------------------------------------
+// -- Hardening
+
+/*
+ * the hardened build puts GUARD_SIZE bytes of GUARD_BYTE before and after
+ * every allocation and fills the freed allocations with FREED_BYTE. the index
+ * keeps the allocations together with their guards, the pointers handed out
+ * point past the front guard. without it the guards are zero bytes wide and
+ * all of this folds away
+ */
+#if defined(PXD_HARDENED)
+constexpr bool HARDENED = true;
+#else
+constexpr bool HARDENED = false;
+#endif
+
+constexpr uint8_t GUARD_BYTE = 0xFD;
+constexpr uint8_t FREED_BYTE = 0xDD;
+
+std::atomic<CorruptionHandler> corruption_handler = nullptr;
+
+auto
+set_corruption_handler(CorruptionHandler handler) noexcept
+  -> CorruptionHandler
+{
+  return corruption_handler.exchange(handler, std::memory_order_acq_rel);
+}
+
+/*
+ * under asan the free blocks are poisoned, so any access to them is reported
+ * where it happens. asan may poison less and unpoison more than asked when the
+ * range does not line up with its granules, it never poisons bytes outside
+ */
+void
+poison(Memory& memory, size_t start_index, size_t size) noexcept
+{
+#if defined(PXD_ASAN)
+  ASAN_POISON_MEMORY_REGION(memory.m_data + start_index, size);
+#else
+  (void)memory;
+  (void)start_index;
+  (void)size;
+#endif
+}
 
 void
-alloc_memory(size_t size)
+unpoison(Memory& memory, size_t start_index, size_t size) noexcept
+{
+#if defined(PXD_ASAN)
+  ASAN_UNPOISON_MEMORY_REGION(memory.m_data + start_index, size);
+#else
+  (void)memory;
+  (void)start_index;
+  (void)size;
+#endif
+}
+
+[[nodiscard]] constexpr auto
+guarded_size(size_t size) noexcept -> size_t
 {
-  memory.m_memory.resize(size);
+  return size > std::numeric_limits<size_t>::max() - (2 * GUARD_SIZE)
+           ? std::numeric_limits<size_t>::max()
+           : size + (2 * GUARD_SIZE);
+}
 
-  MemoryInfo all  = {};
-  all.start_index = 0;
-  all.total_size  = size;
+[[nodiscard]] constexpr auto
+unguarded_size(size_t total_size) noexcept -> size_t
+{
+  return total_size - (2 * GUARD_SIZE);
+}
 
-  memory.m_freed.push_back(all);
+/*
+ * the start index of the allocation whose pointer has the given index
+ */
+[[nodiscard]] constexpr auto
+guarded_index(size_t start_index) noexcept -> size_t
+{
+  return start_index < GUARD_SIZE ? INVALID_INDEX : start_index - GUARD_SIZE;
 }
 
+/*
+ * the origin the allocations are aligned against, so the pointer after the
+ * front guard gets the alignment
+ */
 [[nodiscard]] auto
-malloc(size_t size) noexcept -> void*
+guarded_origin(const Memory& memory) noexcept -> uintptr_t
 {
-  if (memory.m_freed.empty() || size > memory.m_memory.size()) {
-    return nullptr;
+  return reinterpret_cast<uintptr_t>(memory.m_data) + GUARD_SIZE;
+}
+
+void
+default_corruption_handler(const CorruptionReport& report)
+{
+  static constexpr std::array<const char*, 3> KIND_NAMES = {
+    "double free", "invalid free", "buffer overflow"
+  };
+
+  std::fprintf(stderr,
+               "pxd memory pool: %s at %p, block at %zu of %zu bytes\n",
+               KIND_NAMES[static_cast<size_t>(report.kind)],
+               report.pointer,
+               report.start_index,
+               report.total_size);
+  std::abort();
+}
+
+void
+report_corruption(Corruption  kind,
+                  const void* pointer,
+                  size_t      start_index,
+                  size_t      total_size)
+{
+  CorruptionReport report = {};
+  report.kind             = kind;
+  report.pointer          = pointer;
+  report.start_index      = start_index;
+  report.total_size       = total_size;
+
+  CorruptionHandler handler =
+    corruption_handler.load(std::memory_order_acquire);
+
+  if (handler == nullptr) {
+    handler = default_corruption_handler;
+  }
+
+  handler(report);
+}
+
+/*
+ * tells a free of free memory from a free of a pointer which is not the start
+ * of an allocation. the allocation index is not ordered, so the allocation
+ * around an interior pointer is searched block by block
+ */
+void
+report_invalid_free(Memory& memory, const void* mem_pointer, size_t index)
+{
+  const auto free_iter = memory.m_free_tree.find_holding(index);
+
+  if (free_iter != memory.m_free_tree.end()) {
+    report_corruption(Corruption::DOUBLE_FREE,
+                      mem_pointer,
+                      free_iter->first,
+                      free_iter->second.total_size);
+    return;
   }
 
-  if (memory.m_freed.size() > 1) {
-    std::ranges::sort(memory.m_freed,
-                      [](const MemoryInfo& lhs, const MemoryInfo& rhs) {
-                        return lhs.total_size < rhs.total_size;
-                      });
+  for (const auto& [start_index, total_size] : memory.m_allocated) {
+    if (index >= start_index && index < start_index + total_size) {
+      report_corruption(Corruption::INVALID_FREE,
+                        mem_pointer,
+                        start_index + GUARD_SIZE,
+                        unguarded_size(total_size));
+      return;
+    }
   }
 
-  auto selected = memory.m_freed.end();
+  report_corruption(Corruption::INVALID_FREE, mem_pointer, index, 0);
+}
 
-  for (auto iter = memory.m_freed.begin(); iter != memory.m_freed.end();
-       ++iter) {
-    if (iter->total_size >= size) {
-      selected = iter;
-      break;
+/*
+ * fills the guards of the allocation at the given start index, which holds
+ * size bytes between them, and poisons them under asan
+ */
+void
+write_guards(Memory& memory, size_t start_index, size_t size) noexcept
+{
+  if constexpr (HARDENED) {
+    const size_t back_index = start_index + GUARD_SIZE + size;
+
+    std::memset(memory.m_data + start_index, GUARD_BYTE, GUARD_SIZE);
+    std::memset(memory.m_data + back_index, GUARD_BYTE, GUARD_SIZE);
+
+    poison(memory, start_index, GUARD_SIZE);
+    poison(memory, back_index, GUARD_SIZE);
+  }
+}
+
+/*
+ * reports the first overwritten guard byte of the allocation. the guards are
+ * left unpoisoned, the caller frees the allocation or writes them again
+ */
+void
+check_guards(Memory& memory, const MemoryInfo& info)
+{
+  if constexpr (HARDENED) {
+    const size_t back_index =
+      info.start_index + info.total_size - GUARD_SIZE;
+
+    unpoison(memory, info.start_index, GUARD_SIZE);
+    unpoison(memory, back_index, GUARD_SIZE);
+
+    const std::array<size_t, 2> guard_indices = { info.start_index,
+                                                  back_index };
+
+    for (const size_t guard_index : guard_indices) {
+      const uint8_t* guard = memory.m_data + guard_index;
+      const uint8_t* found = std::find_if(
+        guard, guard + GUARD_SIZE, [](uint8_t byte) {
+          return byte != GUARD_BYTE;
+        });
+
+      if (found != guard + GUARD_SIZE) {
+        report_corruption(Corruption::BUFFER_OVERFLOW,
+                          found,
+                          info.start_index + GUARD_SIZE,
+                          unguarded_size(info.total_size));
+        return;
+      }
     }
   }
+}
 
-  if (selected == memory.m_freed.end()) {
-    return nullptr;
+/*
+ * checks the guards of the allocation being freed and fills it with
+ * FREED_BYTE, so a use after free reads a recognizable pattern
+ */
+void
+retire_allocation(Memory& memory, const MemoryInfo& info)
+{
+  if constexpr (HARDENED) {
+    check_guards(memory, info);
+
+    std::memset(
+      memory.m_data + info.start_index, FREED_BYTE, info.total_size);
   }
+}
+
+// -----------------------------------------------------------------------------
+// -- Free Blocks
 
-  void* start_ptr = static_cast<void*>(&memory.m_memory[selected->start_index]);
+/*
+ * keeps the size bins and the poisoning of the free blocks in step with the
+ * free tree
+ */
+struct BinHooks
+{
+  Memory& memory;
+
+  void insert(size_t start_index, const FreeNode& node)
+  {
+    const size_t index = bin_index(node.total_size);
 
-  MemoryInfo allocated  = {};
-  allocated.start_index = selected->start_index;
-  allocated.total_size  = size;
+    MemoryInfo info  = {};
+    info.start_index = start_index;
+    info.total_size  = node.total_size;
 
-  memory.m_allocated.push_back(allocated);
+    memory.m_bins[index].insert(info);
+    memory.m_bin_map |= (static_cast<uint64_t>(1) << index);
 
-  if (selected->total_size > size) {
-    selected->start_index += size;
-    selected->total_size  -= size;
-  } else {
-    memory.m_freed.erase(selected);
+    poison(memory, start_index, node.total_size);
   }
 
-  return start_ptr;
+  void erase(size_t start_index, const FreeNode& node) noexcept
+  {
+    const size_t index = bin_index(node.total_size);
+
+    MemoryInfo info  = {};
+    info.start_index = start_index;
+    info.total_size  = node.total_size;
+
+    memory.m_bins[index].erase(info);
+
+    if (memory.m_bins[index].empty()) {
+      memory.m_bin_map &= ~(static_cast<uint64_t>(1) << index);
+    }
+
+    unpoison(memory, start_index, node.total_size);
+  }
+};
+
+void
+insert_free(Memory& memory, size_t start_index, size_t size, bool is_zero)
+{
+  FreeNode node   = {};
+  node.total_size = size;
+  node.is_zero    = is_zero;
+
+  memory.m_free_tree.insert(start_index, node, BinHooks{ memory });
 }
 
+/*
+ * returns the smallest free block which can hold the given size, ties are
+ * broken by the start index. the result is empty if there is no such block
+ */
 [[nodiscard]] auto
-calloc(size_t size) noexcept -> void*
+find_fit(Memory& memory, size_t size) -> MemoryInfo
 {
-  void* result = malloc(size);
+  const size_t index = bin_index(size);
 
-  if (nullptr == result) {
-    return nullptr;
+  if ((memory.m_bin_map & (static_cast<uint64_t>(1) << index)) != 0) {
+    MemoryInfo key  = {};
+    key.total_size  = size;
+    key.start_index = 0;
+
+    auto iter = memory.m_bins[index].lower_bound(key);
+
+    if (iter != memory.m_bins[index].end()) {
+      return *iter;
+    }
+  }
+
+  if (index + 1 >= BIN_COUNT) {
+    return {};
   }
 
-  std::memset(result, 0, size);
+  const uint64_t upper_bins =
+    memory.m_bin_map & ~((static_cast<uint64_t>(1) << (index + 1)) - 1);
 
-  return result;
+  if (upper_bins == 0) {
+    return {};
+  }
+
+  return *memory.m_bins[std::countr_zero(upper_bins)].begin();
 }
 
-struct AdjacentsInfo
+[[nodiscard]] constexpr auto
+aligned_padding(size_t position, size_t alignment) noexcept -> size_t
 {
-  uint8_t is_found    = 0;
-  size_t  next_index  = std::numeric_limits<std::size_t>::max();
-  size_t  prev_index  = std::numeric_limits<std::size_t>::max();
-  size_t  found_index = std::numeric_limits<std::size_t>::max();
-};
+  return (alignment - (position % alignment)) % alignment;
+}
 
-enum class AdjEnum : uint8_t
+[[nodiscard]] constexpr auto
+round_up(size_t size, size_t alignment) noexcept -> size_t
 {
-  NEXT = 0x0F,
-  PREV = 0xF0,
-  BOTH = 0xFF
-};
+  return size + aligned_padding(size, alignment);
+}
 
-auto
-find_adjacents(const MemoryInfo& found_mem) -> AdjacentsInfo
+/*
+ * the largest size the pool can reach
+ */
+[[nodiscard]] auto
+capacity(const Memory& memory) noexcept -> size_t
 {
-  AdjacentsInfo     adj_info;
-  const std::size_t frees_length = memory.m_freed.size();
+  return memory.m_growable ? memory.m_reserved_size : memory.m_size;
+}
 
-  if (frees_length == 0) {
-    return adj_info;
-  }
+struct ArenaLayout
+{
+  size_t chunk_size     = 0;
+  size_t reserved_size  = 0;
+  size_t committed_size = 0;
+};
 
-  if (frees_length == 1) {
-    MemoryInfo single_mem = memory.m_freed[0];
+/*
+ * the sizes of the arena when it is mapped with pages of the given size
+ */
+[[nodiscard]] auto
+arena_layout(size_t size, const PoolOptions& options, size_t page_size) noexcept
+  -> ArenaLayout
+{
+  const bool growable = options.max_size > size;
+
+  ArenaLayout layout = {};
+  layout.chunk_size  = round_up(
+    std::max(options.grow_size == 0 ? size : options.grow_size, page_size),
+    page_size);
+  layout.reserved_size  = growable
+                            ? round_up(options.max_size, layout.chunk_size)
+                            : round_up(size, layout.chunk_size);
+  layout.committed_size = round_up(size, page_size);
+
+  return layout;
+}
 
-    if (found_mem.is_next_from_given(single_mem)) {
-      adj_info.is_found   |= static_cast<uint8_t>(AdjEnum::PREV);
-      adj_info.prev_index  = 0;
-    } else if (found_mem.is_prev_from_given(single_mem)) {
-      adj_info.is_found   |= static_cast<uint8_t>(AdjEnum::NEXT);
-      adj_info.next_index  = 0;
+/*
+ * maps the arena with explicit huge pages when asked for and configured, with
+ * transparent huge pages when asked for and supported and with normal pages
+ * otherwise. the backing records what was applied
+ */
+[[nodiscard]] auto
+map_arena(size_t             size,
+          const PoolOptions& options,
+          ArenaLayout&       layout,
+          PoolBacking&       backing) -> uint8_t*
+{
+  const size_t page_size      = os::page_size();
+  const size_t huge_page_size = options.huge_pages == HugePages::NONE
+                                  ? 0
+                                  : os::huge_page_size();
+  const bool   use_huge_pages = huge_page_size > page_size;
+
+  uint8_t* data = nullptr;
+
+  if (use_huge_pages && options.huge_pages == HugePages::EXPLICIT) {
+    layout = arena_layout(size, options, huge_page_size);
+    data   = static_cast<uint8_t*>(os::reserve_huge(layout.reserved_size));
+
+    if (data != nullptr && layout.committed_size > 0 &&
+        !os::commit(data, layout.committed_size)) {
+      os::release(data, layout.reserved_size);
+      data = nullptr;
     }
 
-    return adj_info;
+    if (data != nullptr) {
+      backing.page_size  = huge_page_size;
+      backing.huge_pages = HugePages::EXPLICIT;
+    }
   }
 
-  std::size_t cand_prev_found_index = std::numeric_limits<std::size_t>::max();
-  std::size_t cand_next_found_index = std::numeric_limits<std::size_t>::max();
+  if (data == nullptr) {
+    layout = arena_layout(size, options, page_size);
+    data   = static_cast<uint8_t*>(
+      use_huge_pages ? os::reserve_aligned(layout.reserved_size, huge_page_size)
+                     : os::reserve(layout.reserved_size));
 
-  memory.m_freed.push_back(found_mem);
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
 
-  std::ranges::sort(memory.m_freed,
-                    [](const MemoryInfo& lhs, const MemoryInfo& rhs) {
-                      return lhs.start_index < rhs.start_index;
-                    });
+    backing.page_size = page_size;
 
-  const std::size_t frees_length_plus_one = frees_length + 1;
+    if (use_huge_pages && os::advise_huge_pages(data, layout.reserved_size)) {
+      backing.huge_pages = HugePages::TRANSPARENT;
+    }
 
-  for (std::size_t i = 0; i < frees_length_plus_one; ++i) {
-    if (memory.m_freed[i] == found_mem) {
-      adj_info.found_index = i;
-      break;
+    if (layout.committed_size > 0 && !os::commit(data, layout.committed_size)) {
+      os::release(data, layout.reserved_size);
+      throw std::bad_alloc();
     }
   }
 
-  if (adj_info.found_index == 0) {
-    cand_next_found_index = 1;
-  } else if (adj_info.found_index == frees_length) {
-    cand_prev_found_index = adj_info.found_index - 1;
-  } else {
-    cand_prev_found_index = adj_info.found_index - 1;
-    cand_next_found_index = adj_info.found_index + 1;
+  /*
+   * nothing is faulted in yet, so binding after the commit still places all
+   * of the pages
+   */
+  if (options.numa_node >= 0 &&
+      os::bind_node(data, layout.reserved_size, options.numa_node)) {
+    backing.numa_node = options.numa_node;
   }
 
-  if (cand_next_found_index != std::numeric_limits<size_t>::max()) {
-    if (found_mem.is_prev_from_given(memory.m_freed[cand_next_found_index])) {
-      adj_info.is_found   |= static_cast<uint8_t>(AdjEnum::NEXT);
-      adj_info.next_index  = cand_next_found_index;
-    }
+  if (options.populate && layout.committed_size > 0) {
+    os::populate(data, layout.committed_size);
+    backing.populated = true;
   }
 
-  if (cand_prev_found_index != std::numeric_limits<size_t>::max()) {
-    if (found_mem.is_next_from_given(memory.m_freed[cand_prev_found_index])) {
-      adj_info.is_found   |= static_cast<uint8_t>(AdjEnum::PREV);
-      adj_info.prev_index  = cand_prev_found_index;
-    }
+  return data;
+}
+
+/*
+ * returns the free block which can hold the size at the given alignment,
+ * trying the best fit before the block large enough for any padding
+ */
+[[nodiscard]] auto
+find_aligned_fit(Memory&   memory,
+                 size_t    size,
+                 size_t    alignment,
+                 uintptr_t origin) -> MemoryInfo
+{
+  MemoryInfo selected = find_fit(memory, size);
+
+  if (!selected.empty() &&
+      aligned_padding(origin + selected.start_index, alignment) + size >
+        selected.total_size) {
+    selected = find_fit(memory, size + alignment - 1);
   }
 
-  return adj_info;
+  return selected;
 }
 
 void
-free(void* mem_pointer) noexcept
+mark_resident(Memory& memory, size_t start_index, size_t size) noexcept
 {
-  if (memory.m_allocated.empty()) {
+  if (!memory.m_release_chunks) {
     return;
   }
 
-  auto found_info_iter = memory.m_allocated.end();
+  const size_t last_chunk = (start_index + size - 1) / memory.m_chunk_size;
 
-  for (auto iter = memory.m_allocated.begin(); iter != memory.m_allocated.end();
-       ++iter) {
-    if (mem_pointer ==
-        static_cast<void*>(&memory.m_memory[iter->start_index])) {
-      found_info_iter = iter;
-      break;
-    }
+  for (size_t chunk = start_index / memory.m_chunk_size; chunk <= last_chunk;
+       ++chunk) {
+    memory.m_resident_chunks[chunk] = 1;
   }
+}
 
-  if (found_info_iter == memory.m_allocated.end()) {
+/*
+ * discards the pages of the chunks which are completely inside the given free
+ * block and still resident. the discarded pages read as zero again, but the
+ * block is only known to be zero if it was before
+ */
+void
+discard_chunks(Memory& memory, const MemoryInfo& info) noexcept
+{
+  if (!memory.m_release_chunks) {
     return;
   }
 
-  std::memset(&memory.m_memory[found_info_iter->start_index], 0, found_info_iter->total_size);
+  const size_t first_chunk =
+    round_up(info.start_index, memory.m_chunk_size) / memory.m_chunk_size;
+  const size_t end_chunk =
+    (info.start_index + info.total_size) / memory.m_chunk_size;
 
-  AdjacentsInfo adj_info = find_adjacents(*found_info_iter);
+  for (size_t chunk = first_chunk; chunk < end_chunk; ++chunk) {
+    if (memory.m_resident_chunks[chunk] != 0) {
+      os::discard(memory.m_data + (chunk * memory.m_chunk_size),
+                  memory.m_chunk_size);
+      memory.m_resident_chunks[chunk] = 0;
+    }
+  }
+}
 
-  switch (adj_info.is_found) {
-    case 0:
-      memory.m_freed.push_back(*found_info_iter);
-      break;
-    case static_cast<uint8_t>(AdjEnum::NEXT):
-      memory.m_freed[adj_info.next_index].start_index =
-        found_info_iter->start_index;
-      memory.m_freed[adj_info.next_index].total_size +=
-        found_info_iter->total_size;
-      break;
-    case static_cast<uint8_t>(AdjEnum::PREV):
-      memory.m_freed[adj_info.prev_index].total_size +=
-        found_info_iter->total_size;
-      break;
-    case static_cast<uint8_t>(AdjEnum::BOTH):
-      memory.m_freed[adj_info.prev_index].total_size +=
-        (found_info_iter->total_size +
-         memory.m_freed[adj_info.next_index].total_size);
+[[nodiscard]] auto
+grow(Memory& memory, size_t size) -> bool;
 
-      memory.m_freed.erase(memory.m_freed.begin() + adj_info.next_index);
-      break;
-    default:
-      break;
+/*
+ * the allocated bytes count the sizes the users asked for, the guards of the
+ * hardened build are taken off by the callers
+ */
+void
+add_allocated_bytes(Memory& memory, size_t size) noexcept
+{
+  memory.m_allocated_bytes += size;
+  memory.m_peak_bytes = std::max(memory.m_peak_bytes, memory.m_allocated_bytes);
+}
+
+/*
+ * allocates a block whose (origin + start index) is a multiple of the given
+ * alignment. the bytes skipped in front of the block are given back to the
+ * free blocks, so they are never counted as allocated
+ */
+[[nodiscard]] auto
+allocate_index(Memory&   memory,
+               size_t    size,
+               size_t    alignment,
+               uintptr_t origin) -> Allocation
+{
+  if (size == 0 || size > capacity(memory)) {
+    return {};
   }
 
-  if (adj_info.found_index != std::numeric_limits<size_t>::max()) {
-    memory.m_freed.erase(memory.m_freed.begin() + adj_info.found_index);
+  MemoryInfo selected = find_aligned_fit(memory, size, alignment, origin);
+
+  if (selected.empty() && grow(memory, size + alignment - 1)) {
+    selected = find_aligned_fit(memory, size, alignment, origin);
   }
 
-  memory.m_allocated.erase(found_info_iter);
+  if (selected.empty()) {
+    return {};
+  }
+
+  const size_t padding =
+    aligned_padding(origin + selected.start_index, alignment);
+
+  Allocation allocation  = {};
+  allocation.start_index = selected.start_index + padding;
+  allocation.is_zero =
+    memory.m_free_tree
+      .take(memory.m_free_tree.find(selected.start_index),
+            padding,
+            size,
+            BinHooks{ memory })
+      .is_zero;
+
+  memory.m_allocated.emplace(allocation.start_index, size);
+
+  add_allocated_bytes(memory, unguarded_size(size));
+
+  mark_resident(memory, allocation.start_index, size);
+
+  return allocation;
 }
 
+/*
+ * inserts the free block, merging it with the free blocks right before and
+ * after it. the merged block is only zero if all of its parts are
+ */
 void
-release_memory() noexcept
+merge_free(Memory& memory, const MemoryInfo& info, bool is_zero)
 {
-  memory.m_memory.clear();
-  memory.m_freed.clear();
-  memory.m_allocated.clear();
+  FreeNode node   = {};
+  node.total_size = info.total_size;
+  node.is_zero    = is_zero;
+
+  const auto merged_iter =
+    memory.m_free_tree.merge(info.start_index, node, BinHooks{ memory });
+
+  MemoryInfo merged  = {};
+  merged.start_index = merged_iter->first;
+  merged.total_size  = merged_iter->second.total_size;
+
+  discard_chunks(memory, merged);
 }
 
-auto
-total_free_memory() -> size_t
+/*
+ * gives the range back to the free blocks, merging it with the free blocks
+ * right before and after it. only the zero-on-free mode scrubs it
+ */
+void
+release_range(Memory& memory, const MemoryInfo& info)
 {
-  const size_t vec_length = memory.m_freed.size();
+  const bool is_scrubbed = memory.m_scrub == ScrubMode::ZERO_ON_FREE;
 
-  if (vec_length == 0) {
-    return 0;
+  if (is_scrubbed) {
+    std::memset(memory.m_data + info.start_index, 0, info.total_size);
+  }
+
+  merge_free(memory, info, is_scrubbed);
+}
+
+/*
+ * commits at least the given size after the end of a growable pool and gives
+ * it to the free blocks
+ */
+[[nodiscard]] auto
+grow(Memory& memory, size_t size) -> bool
+{
+  if (!memory.m_growable || memory.m_size == memory.m_reserved_size) {
+    return false;
   }
 
-  size_t total_memory = 0;
+  const size_t new_size =
+    std::min(memory.m_size + round_up(size, memory.m_chunk_size),
+             memory.m_reserved_size);
+  const size_t new_committed_size =
+    round_up(new_size, memory.m_backing.page_size);
+
+  if (new_committed_size > memory.m_committed_size) {
+    uint8_t*     committed_end = memory.m_data + memory.m_committed_size;
+    const size_t grown_size    = new_committed_size - memory.m_committed_size;
+
+    if (!os::commit(committed_end, grown_size)) {
+      return false;
+    }
+
+    if (memory.m_backing.populated) {
+      os::populate(committed_end, grown_size);
+    }
 
-  for (size_t i = 0; i < vec_length; ++i) {
-    total_memory += memory.m_freed[i].total_size;
+    memory.m_committed_size = new_committed_size;
   }
 
-  return total_memory;
+  MemoryInfo grown  = {};
+  grown.start_index = memory.m_size;
+  grown.total_size  = new_size - memory.m_size;
+
+  memory.m_size = new_size;
+
+  merge_free(memory, grown, true);
+
+  return true;
 }
 
 auto
-total_allocated_memory() -> size_t
+free_index(Memory& memory, size_t start_index) -> bool
 {
-  const size_t vec_length = memory.m_allocated.size();
+  auto found_info_iter = memory.m_allocated.find(start_index);
 
-  if (vec_length == 0) {
-    return 0;
+  if (found_info_iter == memory.m_allocated.end()) {
+    return false;
   }
 
-  size_t total_memory = 0;
+  MemoryInfo found_mem  = {};
+  found_mem.start_index = found_info_iter->first;
+  found_mem.total_size  = found_info_iter->second;
 
-  for (size_t i = 0; i < vec_length; ++i) {
-    total_memory += memory.m_allocated[i].total_size;
-  }
+  memory.m_allocated.erase(found_info_iter);
+  memory.m_allocated_bytes -= unguarded_size(found_mem.total_size);
+
+  retire_allocation(memory, found_mem);
+  release_range(memory, found_mem);
 
-  return total_memory;
+  return true;
 }
 
+/*
+ * frees the allocation at the given start index with the size the caller
+ * gives. the size is checked against the index, which costs the same lookup
+ * as erasing by key. a wrong size frees the allocation with its own size, the
+ * hardened build reports it as an invalid free first
+ */
 auto
-max_free_memory() -> size_t
+free_index(Memory& memory, size_t start_index, size_t size) -> bool
 {
-  const size_t vec_length = memory.m_freed.size();
+  auto found_info_iter = memory.m_allocated.find(start_index);
 
-  if (vec_length == 0) {
-    return 0;
+  if (found_info_iter == memory.m_allocated.end()) {
+    return false;
   }
 
-  size_t max_memory = 0;
+  if (found_info_iter->second != size) {
+    if constexpr (HARDENED) {
+      report_corruption(Corruption::INVALID_FREE,
+                        memory.m_data + start_index + GUARD_SIZE,
+                        start_index + GUARD_SIZE,
+                        unguarded_size(found_info_iter->second));
+    }
 
-  for (size_t i = 0; i < vec_length; ++i) {
-    max_memory = std::max(memory.m_freed[i].total_size, max_memory);
+    return free_index(memory, start_index);
   }
 
-  return max_memory;
+  memory.m_allocated.erase(found_info_iter);
+  memory.m_allocated_bytes -= unguarded_size(size);
+
+  MemoryInfo found_mem  = {};
+  found_mem.start_index = start_index;
+  found_mem.total_size  = size;
+
+  retire_allocation(memory, found_mem);
+  release_range(memory, found_mem);
+
+  return true;
 }
 
-auto
-min_free_memory() -> size_t
+/*
+ * resizes the allocation at the given start index without moving it, either
+ * by giving its tail back or by taking from the free block right after it.
+ * returns false if the block after it is not free or not large enough
+ */
+[[nodiscard]] auto
+resize_index(Memory& memory, size_t start_index, size_t size) -> bool
 {
-  const size_t vec_length = memory.m_freed.size();
+  auto found_info_iter = memory.m_allocated.find(start_index);
 
-  if (vec_length == 0) {
-    return 0;
+  if (found_info_iter == memory.m_allocated.end()) {
+    return false;
   }
 
-  size_t min_memory = std::numeric_limits<std::size_t>::max();
+  const size_t old_size = found_info_iter->second;
+
+  if (size < old_size) {
+    MemoryInfo tail  = {};
+    tail.start_index = start_index + size;
+    tail.total_size  = old_size - size;
+
+    found_info_iter->second   = size;
+    memory.m_allocated_bytes -= tail.total_size;
+
+    release_range(memory, tail);
 
-  for (size_t i = 0; i < vec_length; ++i) {
-    min_memory = std::min(memory.m_freed[i].total_size, min_memory);
+    return true;
   }
 
-  return min_memory;
+  if (!memory.m_free_tree.extend(
+        start_index + old_size, size - old_size, BinHooks{ memory })) {
+    return false;
+  }
+
+  mark_resident(memory, start_index + old_size, size - old_size);
+
+  found_info_iter->second = size;
+
+  add_allocated_bytes(memory, size - old_size);
+
+  return true;
+}
+
+/*
+ * returns the start index of the given pointer or INVALID_INDEX if it does not
+ * point into the pool
+ */
+[[nodiscard]] auto
+pointer_index(const Memory& memory, const void* mem_pointer) noexcept -> size_t
+{
+  if (mem_pointer == nullptr || memory.m_data == nullptr) {
+    return INVALID_INDEX;
+  }
+
+  const auto* byte_pointer = static_cast<const uint8_t*>(mem_pointer);
+  const auto* memory_begin = memory.m_data;
+
+  if (byte_pointer < memory_begin ||
+      byte_pointer >= memory_begin + capacity(memory)) {
+    return INVALID_INDEX;
+  }
+
+  return static_cast<size_t>(byte_pointer - memory_begin);
+}
+
+// -----------------------------------------------------------------------------
+// -- Thread Caches
+
+struct CacheEntry
+{
+  const Memory*                pool = nullptr;
+  std::shared_ptr<ThreadCache> cache;
+};
+
+struct CacheHandle
+{
+  std::vector<CacheEntry> m_entries;
+
+  CacheHandle()                                    = default;
+  CacheHandle(const CacheHandle& other)            = delete;
+  CacheHandle& operator=(const CacheHandle& other) = delete;
+  CacheHandle(CacheHandle&& other)                 = delete;
+  CacheHandle& operator=(CacheHandle&& other)      = delete;
+
+  /*
+   * the caches outlive their thread, the next thread which needs a cache from
+   * the same pool adopts it together with its spans and pending remote frees
+   */
+  ~CacheHandle() noexcept
+  {
+    for (CacheEntry& entry : m_entries) {
+      entry.cache->m_owner.store(std::thread::id(), std::memory_order_relaxed);
+      entry.cache->m_in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local CacheHandle cache_handle;
+
+/*
+ * a thread holds one cache per pool it allocates from. the caches of the
+ * destroyed pools are dropped from the thread's list on the next miss
+ */
+[[nodiscard]] auto
+local_cache(Memory& memory) -> ThreadCache&
+{
+  for (CacheEntry& entry : cache_handle.m_entries) {
+    if (entry.pool == &memory &&
+        entry.cache->m_pool_alive.load(std::memory_order_acquire)) {
+      return *entry.cache;
+    }
+  }
+
+  std::erase_if(cache_handle.m_entries, [](const CacheEntry& entry) {
+    return !entry.cache->m_pool_alive.load(std::memory_order_acquire);
+  });
+
+  std::lock_guard<std::mutex> lock(memory.m_mutex);
+
+  std::shared_ptr<ThreadCache> adopted;
+
+  for (auto& cache : memory.m_caches) {
+    bool expected = false;
+
+    if (cache->m_in_use.compare_exchange_strong(expected,
+                                                true,
+                                                std::memory_order_acquire)) {
+      adopted = cache;
+      break;
+    }
+  }
+
+  if (adopted == nullptr) {
+    adopted = std::make_shared<ThreadCache>();
+    adopted->m_in_use.store(true, std::memory_order_relaxed);
+
+    memory.m_caches.push_back(adopted);
+  }
+
+  adopted->m_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+  CacheEntry entry = {};
+  entry.pool       = &memory;
+  entry.cache      = adopted;
+
+  cache_handle.m_entries.push_back(entry);
+
+  return *adopted;
+}
+
+/*
+ * only the owner thread writes the cached byte counter, the other threads
+ * just read it for the statistics
+ */
+void
+add_cached_bytes(ThreadCache& cache, size_t size, bool is_added) noexcept
+{
+  const size_t cached = cache.m_cached_bytes.load(std::memory_order_relaxed);
+
+  cache.m_cached_bytes.store(is_added ? cached + size : cached - size,
+                             std::memory_order_relaxed);
+}
+
+/*
+ * only the owner thread counts, so the count needs no atomic increment
+ */
+void
+add_count(std::atomic<size_t>& counter) noexcept
+{
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+[[nodiscard]] auto
+span_of(Memory& memory, size_t start_index) noexcept -> CacheSpan*
+{
+  return memory.m_span_table[start_index / CACHE_SPAN_SIZE].load(
+    std::memory_order_acquire);
+}
+
+[[nodiscard]] auto
+class_of(ThreadCache& cache, size_t block_size) noexcept -> CacheClass&
+{
+  return cache.m_classes[(block_size / CACHE_GRANULE) - 1];
+}
+
+void
+push_cached(ThreadCache& cache, CacheNode* node, size_t block_size) noexcept
+{
+  CacheClass& cache_class = class_of(cache, block_size);
+
+  node->next            = cache_class.free_list;
+  cache_class.free_list = node;
+}
+
+/*
+ * gives a span whose blocks are all free back to the shared pool. its blocks
+ * are unlinked from the free list of its class first, which holds the blocks
+ * of every span of the class
+ */
+void
+release_span(Memory& memory, ThreadCache& cache, CacheSpan* span)
+{
+  CacheClass&  cache_class = class_of(cache, span->block_size);
+  const size_t span_slot   = span->start_index / CACHE_SPAN_SIZE;
+
+  CacheNode** link = &cache_class.free_list;
+
+  while (*link != nullptr) {
+    if (pointer_index(memory, *link) / CACHE_SPAN_SIZE == span_slot) {
+      *link = (*link)->next;
+    } else {
+      link = &(*link)->next;
+    }
+  }
+
+  if (cache_class.bump_span == span) {
+    cache_class.bump_span  = nullptr;
+    cache_class.bump_index = 0;
+    cache_class.bump_end   = 0;
+  }
+
+  add_cached_bytes(cache, CACHE_SPAN_SIZE, false);
+
+  memory.m_span_table[span_slot].store(nullptr, std::memory_order_release);
+
+  {
+    std::lock_guard<std::mutex> lock(memory.m_mutex);
+
+    free_index(memory, span->start_index);
+  }
+
+  std::erase_if(cache.m_spans, [span](const std::unique_ptr<CacheSpan>& owned) {
+    return owned.get() == span;
+  });
+}
+
+/*
+ * takes a block which came back to the owner's free lists off the live count
+ * of its span. the span its class bumps from is kept, so a thread which
+ * allocates and frees a single block does not take a span every time
+ */
+void
+return_cached(Memory& memory, ThreadCache& cache, CacheSpan* span)
+{
+  span->live_count--;
+
+  if (span->live_count == 0 &&
+      class_of(cache, span->block_size).bump_span != span) {
+    release_span(memory, cache, span);
+  }
+}
+
+void
+drain_remote_frees(Memory& memory, ThreadCache& cache)
+{
+  if (cache.m_remote_frees.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+
+  CacheNode* node =
+    cache.m_remote_frees.exchange(nullptr, std::memory_order_acquire);
+
+  while (node != nullptr) {
+    CacheNode* next = node->next;
+    CacheSpan* span = span_of(memory, pointer_index(memory, node));
+
+    push_cached(cache, node, span->block_size);
+
+    cache.m_remote_bytes.fetch_sub(span->block_size, std::memory_order_relaxed);
+    add_cached_bytes(cache, span->block_size, true);
+
+    return_cached(memory, cache, span);
+
+    node = next;
+  }
+}
+
+[[nodiscard]] auto
+refill_class(Memory&      memory,
+             ThreadCache& cache,
+             CacheClass&  cache_class,
+             size_t       block_size) -> bool
+{
+  std::lock_guard<std::mutex> lock(memory.m_mutex);
+
+  const Allocation allocation =
+    allocate_index(memory, CACHE_SPAN_SIZE, CACHE_SPAN_SIZE, 0);
+  const size_t start_index = allocation.start_index;
+
+  if (start_index == INVALID_INDEX) {
+    return false;
+  }
+
+  auto span         = std::make_unique<CacheSpan>();
+  span->owner       = &cache;
+  span->block_size  = block_size;
+  span->start_index = start_index;
+
+  memory.m_span_table[start_index / CACHE_SPAN_SIZE].store(
+    span.get(), std::memory_order_release);
+
+  cache_class.bump_span    = span.get();
+  cache.m_spans.push_back(std::move(span));
+
+  cache_class.bump_index   = start_index;
+  cache_class.bump_end     = start_index + CACHE_SPAN_SIZE;
+  cache_class.bump_is_zero = allocation.is_zero;
+
+  add_cached_bytes(cache, CACHE_SPAN_SIZE, true);
+
+  return true;
+}
+
+[[nodiscard]] auto
+cache_malloc(Memory& memory, size_t size) -> Allocation
+{
+  const size_t class_index = (size - 1) / CACHE_GRANULE;
+  const size_t block_size  = (class_index + 1) * CACHE_GRANULE;
+
+  ThreadCache& cache       = local_cache(memory);
+  CacheClass&  cache_class = cache.m_classes[class_index];
+
+  if (cache_class.free_list == nullptr) {
+    drain_remote_frees(memory, cache);
+  }
+
+  Allocation allocation = {};
+
+  if (cache_class.free_list != nullptr) {
+    CacheNode* node       = cache_class.free_list;
+    cache_class.free_list = node->next;
+
+    /*
+     * a scrubbed block is zero except for the link to the next block
+     */
+    if (memory.m_scrub == ScrubMode::ZERO_ON_FREE) {
+      node->next         = nullptr;
+      allocation.is_zero = true;
+    }
+
+    allocation.start_index = pointer_index(memory, node);
+
+    span_of(memory, allocation.start_index)->live_count++;
+    add_cached_bytes(cache, block_size, false);
+    add_count(cache.m_alloc_count);
+
+    return allocation;
+  }
+
+  if (cache_class.bump_index + block_size > cache_class.bump_end &&
+      !refill_class(memory, cache, cache_class, block_size)) {
+    return allocation;
+  }
+
+  allocation.start_index = cache_class.bump_index;
+  allocation.is_zero     = cache_class.bump_is_zero;
+
+  cache_class.bump_index += block_size;
+  cache_class.bump_span->live_count++;
+
+  add_cached_bytes(cache, block_size, false);
+  add_count(cache.m_alloc_count);
+
+  return allocation;
+}
+
+/*
+ * returns false if the pointer does not belong to a cache span
+ */
+[[nodiscard]] auto
+cache_free(Memory& memory, void* mem_pointer, size_t start_index) -> bool
+{
+  CacheSpan* span = span_of(memory, start_index);
+
+  if (span == nullptr) {
+    return false;
+  }
+
+  if (memory.m_scrub == ScrubMode::ZERO_ON_FREE) {
+    std::memset(mem_pointer, 0, span->block_size);
+  }
+
+  auto* node = ::new (mem_pointer) CacheNode();
+
+  if (span->owner->m_owner.load(std::memory_order_relaxed) ==
+      std::this_thread::get_id()) {
+    ThreadCache& owner = *span->owner;
+
+    push_cached(owner, node, span->block_size);
+    add_cached_bytes(owner, span->block_size, true);
+    add_count(owner.m_free_count);
+
+    return_cached(memory, owner, span);
+
+    return true;
+  }
+
+  ThreadCache& owner = *span->owner;
+
+  owner.m_remote_bytes.fetch_add(span->block_size, std::memory_order_relaxed);
+  owner.m_remote_count.fetch_add(1, std::memory_order_relaxed);
+
+  node->next = owner.m_remote_frees.load(std::memory_order_relaxed);
+
+  while (!owner.m_remote_frees.compare_exchange_weak(
+    node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+  }
+
+  return true;
+}
+
+/*
+ * gives the free spans of the caches back to the shared pool once it runs out,
+ * the spans the classes bump from included. the caches of other live threads
+ * are left alone, only their owner walks their free lists. returns whether a
+ * span was given back
+ */
+[[nodiscard]] auto
+flush_caches(Memory& memory) -> bool
+{
+  std::vector<std::shared_ptr<ThreadCache>> caches;
+
+  {
+    std::lock_guard<std::mutex> lock(memory.m_mutex);
+
+    caches = memory.m_caches;
+  }
+
+  bool is_released = false;
+
+  for (const auto& cache : caches) {
+    const bool is_own = cache->m_owner.load(std::memory_order_relaxed) ==
+                        std::this_thread::get_id();
+    bool expected = false;
+
+    if (!is_own && !cache->m_in_use.compare_exchange_strong(
+                     expected, true, std::memory_order_acquire)) {
+      continue;
+    }
+
+    const size_t span_count = cache->m_spans.size();
+
+    drain_remote_frees(memory, *cache);
+
+    for (size_t i = cache->m_spans.size(); i > 0; i--) {
+      CacheSpan* span = cache->m_spans[i - 1].get();
+
+      if (span->live_count == 0) {
+        release_span(memory, *cache, span);
+      }
+    }
+
+    is_released = is_released || cache->m_spans.size() < span_count;
+
+    if (!is_own) {
+      cache->m_in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  return is_released;
+}
+
+void
+reset_caches(Memory& memory) noexcept
+{
+  for (auto& cache : memory.m_caches) {
+    cache->m_classes = {};
+    cache->m_spans.clear();
+    cache->m_remote_frees.store(nullptr, std::memory_order_relaxed);
+    cache->m_cached_bytes.store(0, std::memory_order_relaxed);
+    cache->m_remote_bytes.store(0, std::memory_order_relaxed);
+    cache->m_alloc_count.store(0, std::memory_order_relaxed);
+    cache->m_free_count.store(0, std::memory_order_relaxed);
+    cache->m_remote_count.store(0, std::memory_order_relaxed);
+  }
+
+  memory.m_span_table.reset();
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * cache blocks are multiples of CACHE_GRANULE away from a span start, so they
+ * share the alignment of the pool up to CACHE_GRANULE
+ */
+[[nodiscard]] auto
+is_cache_aligned(Memory& memory, size_t alignment) noexcept -> bool
+{
+  const auto origin = reinterpret_cast<uintptr_t>(memory.m_data);
+
+  return alignment <= CACHE_GRANULE && (origin % alignment) == 0;
+}
+
+[[nodiscard]] auto
+allocate_shared(Memory& memory, size_t size, size_t alignment) -> Allocation
+{
+  auto lock = lock_memory(memory);
+
+  const Allocation allocation =
+    allocate_index(memory, size, alignment, guarded_origin(memory));
+
+  if (allocation.start_index != INVALID_INDEX) {
+    memory.m_alloc_count++;
+  }
+
+  return allocation;
+}
+
+/*
+ * serves the size from the thread cache if possible, from the shared pool
+ * otherwise. the free spans of the caches are flushed back before it fails.
+ * the hardened build does not cache, its guards have to be checked on every
+ * free
+ */
+[[nodiscard]] auto
+allocate_block(Memory& memory, size_t size, size_t alignment) -> Allocation
+{
+  if (!HARDENED && memory.m_thread_safe && size <= CACHE_MAX_SIZE &&
+      is_cache_aligned(memory, alignment)) {
+    const Allocation allocation = cache_malloc(memory, size);
+
+    if (allocation.start_index != INVALID_INDEX) {
+      return allocation;
+    }
+  }
+
+  Allocation allocation = allocate_shared(memory, size, alignment);
+
+  if (allocation.start_index == INVALID_INDEX && memory.m_thread_safe &&
+      flush_caches(memory)) {
+    allocation = allocate_shared(memory, size, alignment);
+  }
+
+  return allocation;
+}
+
+/*
+ * appends the block to the json array which the string ends in
+ */
+void
+append_json_block(std::string& json, size_t start_index, size_t total_size)
+{
+  json += json.back() == '[' ? "\n    " : ",\n    ";
+  json += "{\"start\": " + std::to_string(start_index) +
+          ", \"size\": " + std::to_string(total_size) + "}";
+}
+
+// -----------------------------------------------------------------------------
+// -- Memory Pool
+
+MemoryPool::MemoryPool()
+  : m_impl(make_memory())
+{
+}
+
+MemoryPool::MemoryPool(size_t size, const PoolOptions& options)
+  : m_impl(make_memory())
+{
+  alloc_memory(size, options);
+}
+
+/*
+ * the caches of this pool may still be referenced by threads, they only get
+ * marked so the threads drop them
+ */
+MemoryPool::~MemoryPool() noexcept
+{
+  const PoolCall call;
+
+  release_memory();
+
+  std::lock_guard<std::mutex> lock(m_impl->m_mutex);
+
+  for (auto& cache : m_impl->m_caches) {
+    cache->m_pool_alive.store(false, std::memory_order_release);
+  }
+}
+
+void
+MemoryPool::alloc_memory(size_t size, const PoolOptions& options)
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  ArenaLayout layout  = arena_layout(size, options, os::page_size());
+  PoolBacking backing = {};
+  backing.page_size   = os::page_size();
+
+  if (layout.reserved_size > 0) {
+    memory.m_data = map_arena(size, options, layout, backing);
+  }
+
+  memory.m_growable       = options.max_size > size;
+  memory.m_reserved_size  = layout.reserved_size;
+  memory.m_committed_size = layout.committed_size;
+  memory.m_chunk_size     = layout.chunk_size;
+  memory.m_backing        = backing;
+  memory.m_release_chunks = options.release_free_chunks;
+  memory.m_scrub          = options.scrub;
+
+  if (options.release_free_chunks) {
+    memory.m_resident_chunks.assign(
+      layout.reserved_size / layout.chunk_size, 1);
+  }
+
+  memory.m_size        = size;
+  memory.m_thread_safe = options.thread_safe;
+
+  if (options.thread_safe) {
+    const size_t span_count = (capacity(memory) / CACHE_SPAN_SIZE) + 1;
+
+    memory.m_span_table =
+      std::make_unique<std::atomic<CacheSpan*>[]>(span_count);
+  }
+
+  if (size > 0) {
+    insert_free(memory, 0, size, true);
+  }
+}
+
+auto
+MemoryPool::malloc(size_t size) noexcept -> void*
+{
+  return aligned_malloc(size, 1);
+}
+
+auto
+MemoryPool::calloc(size_t size) noexcept -> void*
+{
+  return aligned_calloc(size, 1);
+}
+
+auto
+MemoryPool::aligned_malloc(size_t size, size_t alignment) noexcept -> void*
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (!std::has_single_bit(alignment)) {
+    return nullptr;
+  }
+
+  /*
+   * a zero byte request gets a block of one byte, so it still returns a
+   * unique pointer which can be freed
+   */
+  size = std::max<size_t>(size, 1);
+
+  const Allocation allocation =
+    allocate_block(memory, guarded_size(size), alignment);
+
+  if (allocation.start_index == INVALID_INDEX) {
+    memory.m_failed_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  write_guards(memory, allocation.start_index, size);
+
+  void* start_ptr =
+    static_cast<void*>(memory.m_data + allocation.start_index + GUARD_SIZE);
+
+  if (memory.m_scrub == ScrubMode::ZERO_ON_ALLOC && !allocation.is_zero) {
+    std::memset(start_ptr, 0, size);
+  }
+
+  return start_ptr;
+}
+
+auto
+MemoryPool::aligned_calloc(size_t size, size_t alignment) noexcept -> void*
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (!std::has_single_bit(alignment)) {
+    return nullptr;
+  }
+
+  /*
+   * a zero byte request gets a block of one byte, so it still returns a
+   * unique pointer which can be freed
+   */
+  size = std::max<size_t>(size, 1);
+
+  const Allocation allocation =
+    allocate_block(memory, guarded_size(size), alignment);
+
+  if (allocation.start_index == INVALID_INDEX) {
+    memory.m_failed_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  write_guards(memory, allocation.start_index, size);
+
+  void* result =
+    static_cast<void*>(memory.m_data + allocation.start_index + GUARD_SIZE);
+
+  if (!allocation.is_zero) {
+    std::memset(result, 0, size);
+  }
+
+  return result;
+}
+
+auto
+MemoryPool::realloc(void* mem_pointer, size_t size) noexcept -> void*
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (mem_pointer == nullptr) {
+    return malloc(size);
+  }
+
+  if (size == 0) {
+    free(mem_pointer);
+    return nullptr;
+  }
+
+  const size_t start_index = pointer_index(memory, mem_pointer);
+
+  if (start_index == INVALID_INDEX) {
+    return nullptr;
+  }
+
+  if (memory.m_thread_safe) {
+    CacheSpan* span = span_of(memory, start_index);
+
+    if (span != nullptr) {
+      if (size <= span->block_size) {
+        return mem_pointer;
+      }
+
+      void* moved = aligned_malloc(size, alignof(std::max_align_t));
+
+      if (moved != nullptr) {
+        std::memcpy(moved, mem_pointer, span->block_size);
+        free(mem_pointer);
+      }
+
+      return moved;
+    }
+  }
+
+  auto lock = lock_memory(memory);
+
+  const size_t block_index     = guarded_index(start_index);
+  auto         found_info_iter = memory.m_allocated.find(block_index);
+
+  if (found_info_iter == memory.m_allocated.end()) {
+    if constexpr (HARDENED) {
+      report_invalid_free(memory, mem_pointer, start_index);
+    }
+
+    return nullptr;
+  }
+
+  const size_t old_size = unguarded_size(found_info_iter->second);
+
+  if constexpr (HARDENED) {
+    MemoryInfo found_mem  = {};
+    found_mem.start_index = block_index;
+    found_mem.total_size  = found_info_iter->second;
+
+    check_guards(memory, found_mem);
+  }
+
+  if (size == old_size ||
+      resize_index(memory, block_index, guarded_size(size))) {
+    write_guards(memory, block_index, size);
+    return mem_pointer;
+  }
+
+  write_guards(memory, block_index, old_size);
+
+  /*
+   * the moved block keeps the alignment of the old one, up to the alignment
+   * malloc of the system would give
+   */
+  const size_t alignment =
+    std::min(static_cast<size_t>(1) << std::countr_zero(
+               reinterpret_cast<uintptr_t>(mem_pointer)),
+             alignof(std::max_align_t));
+
+  const size_t moved_index =
+    allocate_index(
+      memory, guarded_size(size), alignment, guarded_origin(memory))
+      .start_index;
+
+  if (moved_index == INVALID_INDEX) {
+    memory.m_failed_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  write_guards(memory, moved_index, size);
+
+  std::memcpy(memory.m_data + moved_index + GUARD_SIZE, mem_pointer, old_size);
+
+  free_index(memory, block_index);
+
+  return static_cast<void*>(memory.m_data + moved_index + GUARD_SIZE);
+}
+
+void
+MemoryPool::free(void* mem_pointer) noexcept
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  const size_t start_index = pointer_index(memory, mem_pointer);
+
+  if (start_index == INVALID_INDEX) {
+    return;
+  }
+
+  if (memory.m_thread_safe && cache_free(memory, mem_pointer, start_index)) {
+    return;
+  }
+
+  auto lock = lock_memory(memory);
+
+  if (free_index(memory, guarded_index(start_index))) {
+    memory.m_free_count++;
+  } else if constexpr (HARDENED) {
+    report_invalid_free(memory, mem_pointer, start_index);
+  }
+}
+
+void
+MemoryPool::free(void* mem_pointer, size_t size) noexcept
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (size == 0) {
+    free(mem_pointer);
+    return;
+  }
+
+  const size_t start_index = pointer_index(memory, mem_pointer);
+
+  if (start_index == INVALID_INDEX) {
+    return;
+  }
+
+  /*
+   * the caches never hold blocks larger than their largest class, so the span
+   * lookup is skipped for them
+   */
+  if (memory.m_thread_safe && size <= CACHE_MAX_SIZE &&
+      cache_free(memory, mem_pointer, start_index)) {
+    return;
+  }
+
+  auto lock = lock_memory(memory);
+
+  if (free_index(memory, guarded_index(start_index), guarded_size(size))) {
+    memory.m_free_count++;
+  } else if constexpr (HARDENED) {
+    report_invalid_free(memory, mem_pointer, start_index);
+  }
+}
+
+auto
+MemoryPool::malloc_batch(size_t size, size_t count, void** out_ptrs) noexcept
+  -> bool
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (count == 0) {
+    return true;
+  }
+
+  if (size == 0 || out_ptrs == nullptr ||
+      count > std::numeric_limits<size_t>::max() / size) {
+    return false;
+  }
+
+  auto lock = lock_memory(memory);
+
+  const uintptr_t origin = guarded_origin(memory);
+
+  /*
+   * the guards of the hardened build sit between the blocks, so it always
+   * allocates them one by one
+   */
+  if constexpr (!HARDENED) {
+    const Allocation allocation =
+      allocate_index(memory, size * count, 1, origin);
+
+    if (allocation.start_index != INVALID_INDEX) {
+      /*
+       * the single block is split into count allocations in the index
+       */
+      memory.m_allocated.erase(allocation.start_index);
+
+      for (size_t i = 0; i < count; i++) {
+        const size_t start_index = allocation.start_index + (i * size);
+
+        memory.m_allocated.emplace(start_index, size);
+        out_ptrs[i] = memory.m_data + start_index;
+      }
+
+      if (memory.m_scrub == ScrubMode::ZERO_ON_ALLOC && !allocation.is_zero) {
+        std::memset(out_ptrs[0], 0, size * count);
+      }
+
+      memory.m_alloc_count += count;
+
+      return true;
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const Allocation block =
+      allocate_index(memory, guarded_size(size), 1, origin);
+
+    if (block.start_index == INVALID_INDEX) {
+      for (size_t j = 0; j < i; j++) {
+        free_index(memory,
+                   guarded_index(pointer_index(memory, out_ptrs[j])),
+                   guarded_size(size));
+      }
+
+      memory.m_failed_count.fetch_add(1, std::memory_order_relaxed);
+
+      return false;
+    }
+
+    write_guards(memory, block.start_index, size);
+
+    out_ptrs[i] = memory.m_data + block.start_index + GUARD_SIZE;
+
+    if (memory.m_scrub == ScrubMode::ZERO_ON_ALLOC && !block.is_zero) {
+      std::memset(out_ptrs[i], 0, size);
+    }
+  }
+
+  memory.m_alloc_count += count;
+
+  return true;
+}
+
+void
+MemoryPool::free_batch(void* const* ptrs, size_t count) noexcept
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  if (ptrs == nullptr || count == 0) {
+    return;
+  }
+
+  std::vector<size_t> start_indices;
+
+  try {
+    start_indices.reserve(count);
+  } catch (const std::bad_alloc&) {
+    for (size_t i = 0; i < count; i++) {
+      free(ptrs[i]);
+    }
+
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t start_index = pointer_index(memory, ptrs[i]);
+
+    if (start_index == INVALID_INDEX ||
+        (memory.m_thread_safe && cache_free(memory, ptrs[i], start_index))) {
+      continue;
+    }
+
+    start_indices.push_back(start_index);
+  }
+
+  std::sort(start_indices.begin(), start_indices.end());
+
+  auto lock = lock_memory(memory);
+
+  MemoryInfo run = {};
+
+  for (const size_t pointer_start : start_indices) {
+    const size_t start_index     = guarded_index(pointer_start);
+    auto         found_info_iter = memory.m_allocated.find(start_index);
+
+    if (found_info_iter == memory.m_allocated.end()) {
+      if constexpr (HARDENED) {
+        report_invalid_free(
+          memory, memory.m_data + pointer_start, pointer_start);
+      }
+
+      continue;
+    }
+
+    const size_t total_size = found_info_iter->second;
+
+    memory.m_allocated.erase(found_info_iter);
+    memory.m_allocated_bytes -= unguarded_size(total_size);
+    memory.m_free_count++;
+
+    if constexpr (HARDENED) {
+      MemoryInfo found_mem  = {};
+      found_mem.start_index = start_index;
+      found_mem.total_size  = total_size;
+
+      retire_allocation(memory, found_mem);
+    }
+
+    /*
+     * neighbouring blocks are collected into one run, so the free set is only
+     * touched once per run
+     */
+    if (!run.empty() && run.start_index + run.total_size == start_index) {
+      run.total_size += total_size;
+      continue;
+    }
+
+    if (!run.empty()) {
+      release_range(memory, run);
+    }
+
+    run.start_index = start_index;
+    run.total_size  = total_size;
+  }
+
+  if (!run.empty()) {
+    release_range(memory, run);
+  }
+}
+
+auto
+MemoryPool::owns(const void* mem_pointer) const noexcept -> bool
+{
+  return pointer_index(*m_impl, mem_pointer) != INVALID_INDEX;
+}
+
+auto
+MemoryPool::backing() const noexcept -> PoolBacking
+{
+  return m_impl->m_backing;
+}
+
+auto
+MemoryPool::usable_size(const void* mem_pointer) noexcept -> size_t
+{
+  Memory& memory = *m_impl;
+
+  const size_t start_index = pointer_index(memory, mem_pointer);
+
+  if (start_index == INVALID_INDEX) {
+    return 0;
+  }
+
+  if (memory.m_thread_safe) {
+    const CacheSpan* span = span_of(memory, start_index);
+
+    if (span != nullptr) {
+      return span->block_size;
+    }
+  }
+
+  auto lock = lock_memory(memory);
+
+  auto found_info_iter = memory.m_allocated.find(guarded_index(start_index));
+
+  return found_info_iter == memory.m_allocated.end()
+           ? 0
+           : unguarded_size(found_info_iter->second);
+}
+
+void
+MemoryPool::release_memory() noexcept
+{
+  const PoolCall call;
+
+  Memory& memory = *m_impl;
+
+  auto lock = lock_memory(memory);
+
+  /*
+   * the address range may be mapped again by anyone, it must not stay
+   * poisoned
+   */
+  if (memory.m_data != nullptr) {
+    unpoison(memory, 0, memory.m_size);
+    os::release(memory.m_data, memory.m_reserved_size);
+  }
+
+  memory.m_data           = nullptr;
+  memory.m_size           = 0;
+  memory.m_scrub          = ScrubMode::NONE;
+  memory.m_growable       = false;
+  memory.m_reserved_size  = 0;
+  memory.m_committed_size = 0;
+  memory.m_chunk_size     = 0;
+  memory.m_release_chunks = false;
+  memory.m_resident_chunks.clear();
+  memory.m_backing = {};
+
+  memory.m_free_tree.clear();
+  memory.m_allocated.clear();
+
+  memory.m_allocated_bytes = 0;
+  memory.m_peak_bytes      = 0;
+  memory.m_alloc_count     = 0;
+  memory.m_free_count      = 0;
+  memory.m_failed_count.store(0, std::memory_order_relaxed);
+
+  for (FreeBin& bin : memory.m_bins) {
+    bin.clear();
+  }
+
+  memory.m_bin_map = 0;
+
+  reset_caches(memory);
+
+  memory.m_thread_safe = false;
+}
+
+void
+MemoryPool::prepare_fork() noexcept
+{
+  m_impl->m_mutex.lock();
+}
+
+void
+MemoryPool::finish_fork() noexcept
+{
+  m_impl->m_mutex.unlock();
+}
+
+auto
+MemoryPool::stats() -> PoolStats
+{
+  Memory& memory = *m_impl;
+
+  auto lock = lock_memory(memory);
+
+  PoolStats pool_stats       = {};
+  pool_stats.free_bytes      = memory.m_free_tree.free_bytes();
+  pool_stats.allocated_bytes = memory.m_allocated_bytes;
+  pool_stats.peak_bytes      = memory.m_peak_bytes;
+  pool_stats.alloc_count     = memory.m_alloc_count;
+  pool_stats.free_count      = memory.m_free_count;
+  pool_stats.failed_count =
+    memory.m_failed_count.load(std::memory_order_relaxed);
+
+  if (memory.m_bin_map != 0) {
+    const size_t max_index =
+      BIN_COUNT - 1 - std::countl_zero(memory.m_bin_map);
+    const auto min_index =
+      static_cast<size_t>(std::countr_zero(memory.m_bin_map));
+
+    pool_stats.largest_free_block =
+      memory.m_bins[max_index].rbegin()->total_size;
+    pool_stats.smallest_free_block =
+      memory.m_bins[min_index].begin()->total_size;
+  }
+
+  /*
+   * the bytes the caches hold are free for the users
+   */
+  for (const auto& cache : memory.m_caches) {
+    const size_t cached =
+      cache->m_cached_bytes.load(std::memory_order_relaxed) +
+      cache->m_remote_bytes.load(std::memory_order_relaxed);
+
+    pool_stats.free_bytes      += cached;
+    pool_stats.allocated_bytes -= cached;
+    pool_stats.alloc_count +=
+      cache->m_alloc_count.load(std::memory_order_relaxed);
+    pool_stats.free_count +=
+      cache->m_free_count.load(std::memory_order_relaxed) +
+      cache->m_remote_count.load(std::memory_order_relaxed);
+  }
+
+  return pool_stats;
+}
+
+auto
+MemoryPool::snapshot() -> PoolSnapshot
+{
+  Memory& memory = *m_impl;
+
+  auto lock = lock_memory(memory);
+
+  PoolSnapshot pool_snapshot = {};
+
+  /*
+   * malloc aligns the pointer after the front guard and needs room for both
+   * guards, the allocations are counted without them
+   */
+  const uintptr_t origin = guarded_origin(memory);
+
+  for (const auto& [start_index, node] : memory.m_free_tree) {
+    const size_t total_size = node.total_size;
+
+    pool_snapshot.free_histogram[bin_index(total_size)]++;
+    pool_snapshot.largest_free_block =
+      std::max(pool_snapshot.largest_free_block, total_size);
+
+    for (size_t i = 0; i < ALIGNMENT_COUNT; i++) {
+      const size_t padding =
+        aligned_padding(origin + start_index, static_cast<size_t>(1) << i);
+
+      if (total_size > padding + (2 * GUARD_SIZE)) {
+        size_t& largest = pool_snapshot.largest_aligned_block[i];
+        largest = std::max(largest, unguarded_size(total_size - padding));
+      }
+    }
+  }
+
+  for (const auto& [start_index, total_size] : memory.m_allocated) {
+    pool_snapshot.allocated_histogram[bin_index(unguarded_size(total_size))]++;
+  }
+
+  pool_snapshot.total_free_bytes = memory.m_free_tree.free_bytes();
+
+  if (pool_snapshot.total_free_bytes > 0) {
+    pool_snapshot.fragmentation =
+      1.0 - (static_cast<double>(pool_snapshot.largest_free_block) /
+             static_cast<double>(pool_snapshot.total_free_bytes));
+  }
+
+  return pool_snapshot;
+}
+
+auto
+MemoryPool::layout_json() -> std::string
+{
+  Memory& memory = *m_impl;
+
+  auto lock = lock_memory(memory);
+
+  std::string json = "{\n  \"size\": " + std::to_string(memory.m_size) +
+                     ",\n  \"free\": [";
+
+  for (const auto& [start_index, node] : memory.m_free_tree) {
+    append_json_block(json, start_index, node.total_size);
+  }
+
+  json += "\n  ],\n  \"allocated\": [";
+
+  /*
+   * the allocation index is a hash map, it is ordered for the output
+   */
+  const std::map<size_t, size_t> allocated(memory.m_allocated.begin(),
+                                           memory.m_allocated.end());
+
+  for (const auto& [start_index, total_size] : allocated) {
+    append_json_block(json, start_index, total_size);
+  }
+
+  json += "\n  ]\n}\n";
+
+  return json;
+}
+
+auto
+MemoryPool::total_free_memory() -> size_t
+{
+  return stats().free_bytes;
+}
+
+auto
+MemoryPool::total_allocated_memory() -> size_t
+{
+  return stats().allocated_bytes;
+}
+
+auto
+MemoryPool::max_free_memory() -> size_t
+{
+  return stats().largest_free_block;
+}
+
+auto
+MemoryPool::min_free_memory() -> size_t
+{
+  return stats().smallest_free_block;
+}
+
+// -----------------------------------------------------------------------------
+// -- Default Pool
+
+auto
+default_pool() noexcept -> MemoryPool&
+{
+  /*
+   * never destroyed, so the frees of the static objects destroyed after it
+   * still find it
+   */
+  alignas(MemoryPool) static std::byte storage[sizeof(MemoryPool)];
+  static MemoryPool* pool = ::new (static_cast<void*>(storage)) MemoryPool();
+
+  return *pool;
+}
+
+void
+alloc_memory(size_t size, const PoolOptions& options)
+{
+  default_pool().alloc_memory(size, options);
+}
+
+[[nodiscard]] auto
+malloc(size_t size) noexcept -> void*
+{
+  return default_pool().malloc(size);
+}
+
+[[nodiscard]] auto
+calloc(size_t size) noexcept -> void*
+{
+  return default_pool().calloc(size);
+}
+
+[[nodiscard]] auto
+aligned_malloc(size_t size, size_t alignment) noexcept -> void*
+{
+  return default_pool().aligned_malloc(size, alignment);
+}
+
+[[nodiscard]] auto
+aligned_calloc(size_t size, size_t alignment) noexcept -> void*
+{
+  return default_pool().aligned_calloc(size, alignment);
+}
+
+[[nodiscard]] auto
+realloc(void* mem_pointer, size_t size) noexcept -> void*
+{
+  return default_pool().realloc(mem_pointer, size);
+}
+
+void
+free(void* mem_pointer) noexcept
+{
+  default_pool().free(mem_pointer);
+}
+
+void
+free(void* mem_pointer, size_t size) noexcept
+{
+  default_pool().free(mem_pointer, size);
+}
+
+auto
+malloc_batch(size_t size, size_t count, void** out_ptrs) noexcept -> bool
+{
+  return default_pool().malloc_batch(size, count, out_ptrs);
+}
+
+void
+free_batch(void* const* ptrs, size_t count) noexcept
+{
+  default_pool().free_batch(ptrs, count);
+}
+
+void
+release_memory() noexcept
+{
+  default_pool().release_memory();
+}
+
+auto
+backing() noexcept -> PoolBacking
+{
+  return default_pool().backing();
+}
+
+auto
+total_free_memory() -> size_t
+{
+  return default_pool().total_free_memory();
+}
+
+auto
+total_allocated_memory() -> size_t
+{
+  return default_pool().total_allocated_memory();
+}
+
+auto
+max_free_memory() -> size_t
+{
+  return default_pool().max_free_memory();
+}
+
+auto
+min_free_memory() -> size_t
+{
+  return default_pool().min_free_memory();
+}
+
+auto
+stats() -> PoolStats
+{
+  return default_pool().stats();
+}
+
+auto
+snapshot() -> PoolSnapshot
+{
+  return default_pool().snapshot();
+}
+
+auto
+layout_json() -> std::string
+{
+  return default_pool().layout_json();
+}
+
+// -----------------------------------------------------------------------------
+// -- Hooks
+
+auto
+hooks::in_pool_call() noexcept -> bool
+{
+  return t_in_pool_call;
 }
 
 } // namespace pxd::memory
@@ -0,0 +1,264 @@
+#include "../includes/memory_pool.hpp"
+#include "pool_hooks.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/*
+ * replaces the global operator new and delete with the default pool. linking
+ * this translation unit into a binary is the opt-in. the pool is used once
+ * alloc_memory is called, which has to happen before other threads allocate.
+ * until then and whenever the pool is full the allocations go to the system
+ * allocator. frees are routed by checking whether the pointer lies inside the
+ * pool.
+ *
+ * the default pool only takes a lock when PoolOptions::thread_safe is set, so
+ * a binary which allocates from more than one thread has to set it in its
+ * alloc_memory call
+ */
+
+namespace {
+
+constexpr size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+[[nodiscard]] auto
+system_malloc(size_t size, size_t alignment) noexcept -> void*
+{
+  /*
+   * new has to return a unique pointer even for zero bytes, which malloc and
+   * aligned_alloc do not promise
+   */
+  size = std::max<size_t>(size, 1);
+
+  if (alignment <= DEFAULT_ALIGNMENT) {
+    return std::malloc(size);
+  }
+
+  /*
+   * aligned_alloc wants the size to be a multiple of the alignment
+   */
+  const size_t aligned_size = ((size + alignment - 1) / alignment) * alignment;
+
+#if defined(_WIN32)
+  return _aligned_malloc(aligned_size, alignment);
+#else
+  return std::aligned_alloc(alignment, aligned_size);
+#endif
+}
+
+void
+system_free(void* ptr, [[maybe_unused]] size_t alignment) noexcept
+{
+#if defined(_WIN32)
+  if (alignment > DEFAULT_ALIGNMENT) {
+    _aligned_free(ptr);
+    return;
+  }
+#endif
+
+  std::free(ptr);
+}
+
+[[nodiscard]] auto
+allocate_nothrow(size_t size, size_t alignment) noexcept -> void*
+{
+  if (!pxd::memory::hooks::in_pool_call()) {
+    void* ptr = pxd::memory::default_pool().aligned_malloc(size, alignment);
+
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
+  return system_malloc(size, alignment);
+}
+
+[[nodiscard]] auto
+allocate(size_t size, size_t alignment) -> void*
+{
+  while (true) {
+    void* ptr = allocate_nothrow(size, alignment);
+
+    if (ptr != nullptr) {
+      return ptr;
+    }
+
+    std::new_handler handler = std::get_new_handler();
+
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    handler();
+  }
+}
+
+/*
+ * a size of zero is the unsized delete
+ */
+void
+deallocate(void* ptr, size_t size, size_t alignment) noexcept
+{
+  if (ptr == nullptr) {
+    return;
+  }
+
+  /*
+   * the pool only allocates its bookkeeping from the system allocator, so
+   * none of the pointers it frees can be inside it
+   */
+  if (!pxd::memory::hooks::in_pool_call()) {
+    pxd::memory::MemoryPool& pool = pxd::memory::default_pool();
+
+    if (pool.owns(ptr)) {
+      pool.free(ptr, size);
+      return;
+    }
+  }
+
+  system_free(ptr, alignment);
+}
+
+[[nodiscard]] auto
+to_size(std::align_val_t alignment) noexcept -> size_t
+{
+  return static_cast<size_t>(alignment);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// -- Operator New
+
+auto
+operator new(size_t size) -> void*
+{
+  return allocate(size, DEFAULT_ALIGNMENT);
+}
+
+auto
+operator new[](size_t size) -> void*
+{
+  return allocate(size, DEFAULT_ALIGNMENT);
+}
+
+auto
+operator new(size_t size, const std::nothrow_t& /*tag*/) noexcept -> void*
+{
+  return allocate_nothrow(size, DEFAULT_ALIGNMENT);
+}
+
+auto
+operator new[](size_t size, const std::nothrow_t& /*tag*/) noexcept -> void*
+{
+  return allocate_nothrow(size, DEFAULT_ALIGNMENT);
+}
+
+auto
+operator new(size_t size, std::align_val_t alignment) -> void*
+{
+  return allocate(size, to_size(alignment));
+}
+
+auto
+operator new[](size_t size, std::align_val_t alignment) -> void*
+{
+  return allocate(size, to_size(alignment));
+}
+
+auto
+operator new(size_t                size,
+             std::align_val_t      alignment,
+             const std::nothrow_t& /*tag*/) noexcept -> void*
+{
+  return allocate_nothrow(size, to_size(alignment));
+}
+
+auto
+operator new[](size_t                size,
+               std::align_val_t      alignment,
+               const std::nothrow_t& /*tag*/) noexcept -> void*
+{
+  return allocate_nothrow(size, to_size(alignment));
+}
+
+// -----------------------------------------------------------------------------
+// -- Operator Delete
+
+void
+operator delete(void* ptr) noexcept
+{
+  deallocate(ptr, 0, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+  deallocate(ptr, 0, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+  deallocate(ptr, 0, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete[](void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+  deallocate(ptr, 0, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete(void* ptr, size_t size) noexcept
+{
+  deallocate(ptr, size, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete[](void* ptr, size_t size) noexcept
+{
+  deallocate(ptr, size, DEFAULT_ALIGNMENT);
+}
+
+void
+operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, 0, to_size(alignment));
+}
+
+void
+operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, 0, to_size(alignment));
+}
+
+void
+operator delete(void*                 ptr,
+                std::align_val_t      alignment,
+                const std::nothrow_t& /*tag*/) noexcept
+{
+  deallocate(ptr, 0, to_size(alignment));
+}
+
+void
+operator delete[](void*                 ptr,
+                  std::align_val_t      alignment,
+                  const std::nothrow_t& /*tag*/) noexcept
+{
+  deallocate(ptr, 0, to_size(alignment));
+}
+
+void
+operator delete(void* ptr, size_t size, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, size, to_size(alignment));
+}
+
+void
+operator delete[](void* ptr, size_t size, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, size, to_size(alignment));
+}
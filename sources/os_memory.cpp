@@ -0,0 +1,315 @@
+#include "os_memory.hpp"
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cstdio>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace pxd::memory::os {
+
+namespace {
+
+/*
+ * writes one byte per page, the range has to be committed and zero
+ */
+void
+touch_pages(void* address, size_t size, size_t page_size) noexcept
+{
+  auto* bytes = static_cast<volatile unsigned char*>(address);
+
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    bytes[offset] = 0;
+  }
+}
+
+} // namespace
+
+#if defined(_WIN32)
+
+auto
+page_size() noexcept -> size_t
+{
+  SYSTEM_INFO info = {};
+  GetSystemInfo(&info);
+
+  return static_cast<size_t>(info.dwPageSize);
+}
+
+auto
+reserve(size_t size) noexcept -> void*
+{
+  return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+auto
+huge_page_size() noexcept -> size_t
+{
+  return static_cast<size_t>(GetLargePageMinimum());
+}
+
+/*
+ * large pages have to be committed when they are reserved and need the lock
+ * pages privilege, which does not fit the reserve and commit model
+ */
+auto
+reserve_huge(size_t /*size*/) noexcept -> void*
+{
+  return nullptr;
+}
+
+/*
+ * a reservation can not be trimmed, so an aligned address inside a larger one
+ * is reserved again after releasing it. another thread may take the address
+ * in between, hence the retries
+ */
+auto
+reserve_aligned(size_t size, size_t alignment) noexcept -> void*
+{
+  for (int attempt = 0; attempt < 8; ++attempt) {
+    void* address = reserve(size + alignment);
+
+    if (address == nullptr) {
+      return nullptr;
+    }
+
+    const auto aligned =
+      ((reinterpret_cast<uintptr_t>(address) + alignment - 1) / alignment) *
+      alignment;
+
+    VirtualFree(address, 0, MEM_RELEASE);
+
+    address = VirtualAlloc(
+      reinterpret_cast<void*>(aligned), size, MEM_RESERVE, PAGE_NOACCESS);
+
+    if (address != nullptr) {
+      return address;
+    }
+  }
+
+  return reserve(size);
+}
+
+auto
+commit(void* address, size_t size) noexcept -> bool
+{
+  return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void
+discard(void* address, size_t size) noexcept
+{
+  VirtualAlloc(address, size, MEM_RESET, PAGE_READWRITE);
+}
+
+void
+release(void* address, size_t size) noexcept
+{
+  VirtualFree(address, 0, MEM_RELEASE);
+}
+
+auto
+advise_huge_pages(void* /*address*/, size_t /*size*/) noexcept -> bool
+{
+  return false;
+}
+
+void
+populate(void* address, size_t size) noexcept
+{
+  touch_pages(address, size, page_size());
+}
+
+/*
+ * the numa node of a windows range is chosen when it is reserved, with
+ * VirtualAllocExNuma, not afterwards
+ */
+auto
+bind_node(void* /*address*/, size_t /*size*/, int /*node*/) noexcept -> bool
+{
+  return false;
+}
+
+#else
+
+auto
+page_size() noexcept -> size_t
+{
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+auto
+reserve(size_t size) noexcept -> void*
+{
+  void* address =
+    mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  return address == MAP_FAILED ? nullptr : address;
+}
+
+auto
+huge_page_size() noexcept -> size_t
+{
+#if defined(__linux__)
+  std::FILE* meminfo = std::fopen("/proc/meminfo", "r");
+
+  if (meminfo == nullptr) {
+    return 0;
+  }
+
+  char   line[128] = {};
+  size_t size_kb   = 0;
+
+  while (std::fgets(line, sizeof(line), meminfo) != nullptr) {
+    if (std::sscanf(line, "Hugepagesize: %zu kB", &size_kb) == 1) {
+      break;
+    }
+  }
+
+  std::fclose(meminfo);
+
+  return size_kb * 1024;
+#else
+  return 0;
+#endif
+}
+
+auto
+reserve_huge(size_t size) noexcept -> void*
+{
+#if defined(MAP_HUGETLB)
+  /*
+   * the huge pages are reserved here for the whole range, so the mapping
+   * fails up front instead of on the first touch when there are too few
+   */
+  void* address = mmap(nullptr,
+                       size,
+                       PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                       -1,
+                       0);
+
+  return address == MAP_FAILED ? nullptr : address;
+#else
+  return nullptr;
+#endif
+}
+
+/*
+ * reserves one alignment more than asked for and unmaps the ends around the
+ * aligned part
+ */
+auto
+reserve_aligned(size_t size, size_t alignment) noexcept -> void*
+{
+  auto* address = static_cast<unsigned char*>(reserve(size + alignment));
+
+  if (address == nullptr) {
+    return nullptr;
+  }
+
+  const auto begin = reinterpret_cast<uintptr_t>(address);
+  const auto head  = static_cast<size_t>(
+    (((begin + alignment - 1) / alignment) * alignment) - begin);
+
+  if (head > 0) {
+    munmap(address, head);
+  }
+
+  if (alignment - head > 0) {
+    munmap(address + head + size, alignment - head);
+  }
+
+  return address + head;
+}
+
+auto
+commit(void* address, size_t size) noexcept -> bool
+{
+  return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void
+discard(void* address, size_t size) noexcept
+{
+#if defined(__APPLE__)
+  madvise(address, size, MADV_FREE);
+#else
+  madvise(address, size, MADV_DONTNEED);
+#endif
+}
+
+void
+release(void* address, size_t size) noexcept
+{
+  munmap(address, size);
+}
+
+auto
+advise_huge_pages(void* address, size_t size) noexcept -> bool
+{
+#if defined(MADV_HUGEPAGE)
+  return madvise(address, size, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+
+void
+populate(void* address, size_t size) noexcept
+{
+#if defined(MADV_POPULATE_WRITE)
+  if (madvise(address, size, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+#endif
+
+  /*
+   * kernels before 5.14 do not know MADV_POPULATE_WRITE
+   */
+  touch_pages(address, size, page_size());
+}
+
+auto
+bind_node(void* address, size_t size, int node) noexcept -> bool
+{
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int    MPOL_BIND_MODE = 2;
+  constexpr size_t WORD_BITS      = sizeof(unsigned long) * 8;
+  constexpr size_t MASK_WORDS     = 16;
+
+  unsigned long mask[MASK_WORDS] = {};
+  const auto    node_index       = static_cast<size_t>(node);
+
+  if (node < 0 || node_index >= MASK_WORDS * WORD_BITS) {
+    return false;
+  }
+
+  mask[node_index / WORD_BITS] = 1UL << (node_index % WORD_BITS);
+
+  /*
+   * the kernel reads one bit less than maxnode
+   */
+  return syscall(SYS_mbind,
+                 address,
+                 size,
+                 MPOL_BIND_MODE,
+                 mask,
+                 (MASK_WORDS * WORD_BITS) + 1,
+                 0) == 0;
+#else
+  return false;
+#endif
+}
+
+#endif
+
+} // namespace pxd::memory::os
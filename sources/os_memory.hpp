@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pxd::memory::os {
+
+[[nodiscard]] auto
+page_size() noexcept -> size_t;
+
+/*
+ * reserves address space without backing it, nullptr on failure
+ */
+[[nodiscard]] auto
+reserve(size_t size) noexcept -> void*;
+
+/*
+ * the size of the default huge pages, zero if the system has none
+ */
+[[nodiscard]] auto
+huge_page_size() noexcept -> size_t;
+
+/*
+ * reserves address space backed by explicit huge pages, the size has to be a
+ * multiple of huge_page_size. nullptr when too few huge pages are configured
+ */
+[[nodiscard]] auto
+reserve_huge(size_t size) noexcept -> void*;
+
+/*
+ * reserves address space starting at a multiple of the alignment, which has
+ * to be a multiple of the page size. release it with the same size
+ */
+[[nodiscard]] auto
+reserve_aligned(size_t size, size_t alignment) noexcept -> void*;
+
+/*
+ * makes the reserved range readable and writable, the pages are zero
+ */
+[[nodiscard]] auto
+commit(void* address, size_t size) noexcept -> bool;
+
+/*
+ * gives the physical pages of a committed range back to the operating system
+ * while the range stays usable, its contents are undefined afterwards
+ */
+void
+discard(void* address, size_t size) noexcept;
+
+void
+release(void* address, size_t size) noexcept;
+
+/*
+ * asks for transparent huge pages for the range, false if the system does
+ * not support them
+ */
+[[nodiscard]] auto
+advise_huge_pages(void* address, size_t size) noexcept -> bool;
+
+/*
+ * faults in the pages of a committed range up front, so the first writes do
+ * not take page faults
+ */
+void
+populate(void* address, size_t size) noexcept;
+
+/*
+ * places the pages of the range on the given numa node, false if the node
+ * does not exist or the system has no numa support
+ */
+[[nodiscard]] auto
+bind_node(void* address, size_t size, int node) noexcept -> bool;
+
+} // namespace pxd::memory::os
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace pxd::memory::hooks {
+
+/*
+ * true while the calling thread runs inside a pool. the replaced allocation
+ * functions send the allocations a pool makes for its own bookkeeping to the
+ * system allocator, so they never come back into the pool
+ */
+[[nodiscard]] auto
+in_pool_call() noexcept -> bool;
+
+} // namespace pxd::memory::hooks
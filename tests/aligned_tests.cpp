@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "../includes/allocator.hpp"
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST(Aligned, Malloc)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(256);
+
+  void* temp   = pxd::memory::malloc(3);
+  void* temp_2 = pxd::memory::aligned_malloc(64, 64);
+
+  EXPECT_NE(temp_2, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(temp_2) % 64);
+  EXPECT_EQ(67, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(189, pxd::memory::total_free_memory());
+
+  pxd::memory::free(temp_2);
+
+  EXPECT_EQ(3, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(253, pxd::memory::total_free_memory());
+  EXPECT_EQ(253, pxd::memory::max_free_memory());
+
+  pxd::memory::free(temp);
+
+  EXPECT_EQ(256, pxd::memory::max_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Aligned, Calloc)
+{
+  pxd::memory::alloc_memory(256);
+
+  void* temp = pxd::memory::malloc(5);
+  auto* arr  = static_cast<double*>(pxd::memory::aligned_calloc(
+    8 * sizeof(double), alignof(double)));
+
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arr) % alignof(double));
+
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_DOUBLE_EQ(0.0, arr[i]);
+  }
+
+  pxd::memory::release_memory();
+}
+
+TEST(Aligned, InvalidAlignment)
+{
+  pxd::memory::alloc_memory(256);
+
+  EXPECT_EQ(nullptr, pxd::memory::aligned_malloc(16, 24));
+  EXPECT_EQ(nullptr, pxd::memory::aligned_malloc(16, 0));
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+
+  pxd::memory::release_memory();
+}
+
+struct alignas(32) Vec8
+{
+  float m_values[8];
+};
+
+TEST(Aligned, OverAlignedAllocator)
+{
+  pxd::memory::alloc_memory(1024);
+
+  void* temp = pxd::memory::malloc(1);
+
+  std::vector<Vec8, pxd::memory::allocator<Vec8>> vectors(4);
+
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(vectors.data()) % 32);
+  EXPECT_EQ(1 + 4 * sizeof(Vec8), pxd::memory::total_allocated_memory());
+
+  pxd::memory::release_memory();
+}
@@ -2,11 +2,14 @@
 
 #include "../includes/allocator.hpp"
 #include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
 
 #include <vector>
 
 TEST(Allocator, Vector)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(1024);
 
   EXPECT_EQ(1024, pxd::memory::total_free_memory());
@@ -23,6 +26,8 @@ TEST(Allocator, Vector)
 
 TEST(Allocator, ResizeVector)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(1024);
 
   EXPECT_EQ(1024, pxd::memory::total_free_memory());
@@ -46,6 +51,8 @@ TEST(Allocator, ResizeVector)
 
 TEST(Allocator, MultipleVectors)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(1024);
 
   EXPECT_EQ(1024, pxd::memory::total_free_memory());
@@ -65,3 +72,20 @@ TEST(Allocator, MultipleVectors)
 
   pxd::memory::release_memory();
 }
+
+TEST(Allocator, ZeroSize)
+{
+  pxd::memory::alloc_memory(256);
+
+  pxd::memory::allocator<int> alloc;
+
+  int* temp = alloc.allocate(0);
+
+  EXPECT_NE(temp, nullptr);
+
+  alloc.deallocate(temp, 0);
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+
+  pxd::memory::release_memory();
+}
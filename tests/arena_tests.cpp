@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "../includes/monotonic_arena.hpp"
+
+#include <cstdint>
+#include <limits>
+
+TEST(Arena, Bump)
+{
+  pxd::memory::MemoryPool      pool(pxd::memory::SIZE_1MB);
+  pxd::memory::monotonic_arena arena(pool, 1024);
+
+  auto* first  = static_cast<uint8_t*>(arena.allocate(10, 1));
+  auto* second = static_cast<uint8_t*>(arena.allocate(10, 1));
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first + 10, second);
+
+  void* aligned = arena.allocate(8, 64);
+
+  ASSERT_NE(aligned, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 64);
+
+  arena.free(first);
+
+  EXPECT_EQ(1024, pool.total_allocated_memory());
+  EXPECT_EQ(nullptr, arena.allocate(0));
+  EXPECT_EQ(nullptr, arena.allocate(8, 3));
+}
+
+TEST(Arena, MarkerAndReset)
+{
+  pxd::memory::MemoryPool      pool(pxd::memory::SIZE_1MB);
+  pxd::memory::monotonic_arena arena(pool, 256);
+
+  void* kept = arena.allocate(100, 1);
+
+  const pxd::memory::ArenaMarker marker = arena.mark();
+
+  void* temp = arena.allocate(100, 1);
+
+  for (size_t i = 0; i < 10; i++) {
+    ASSERT_NE(arena.allocate(200, 1), nullptr);
+  }
+
+  EXPECT_LT(1, arena.chunk_count());
+
+  arena.rewind(marker);
+
+  EXPECT_EQ(100, arena.used_memory());
+  EXPECT_EQ(temp, arena.allocate(100, 1));
+
+  arena.reset();
+
+  EXPECT_EQ(0, arena.used_memory());
+  EXPECT_EQ(kept, arena.allocate(100, 1));
+
+  arena.release();
+
+  EXPECT_EQ(0, arena.chunk_count());
+  EXPECT_EQ(0, pool.total_allocated_memory());
+}
+
+TEST(Arena, Scope)
+{
+  pxd::memory::MemoryPool      pool(pxd::memory::SIZE_1MB);
+  pxd::memory::monotonic_arena arena(pool);
+
+  void* kept = arena.allocate(64);
+
+  {
+    pxd::memory::arena_scope scope(arena);
+
+    for (size_t i = 0; i < 100; i++) {
+      ASSERT_NE(arena.easy_malloc<uint64_t>(16), nullptr);
+    }
+  }
+
+  EXPECT_EQ(64, arena.used_memory());
+  EXPECT_NE(kept, arena.allocate(64));
+}
+
+TEST(Arena, LargeRequest)
+{
+  pxd::memory::MemoryPool      pool(pxd::memory::SIZE_1MB);
+  pxd::memory::monotonic_arena arena(pool, 1024);
+
+  auto* large = static_cast<uint8_t*>(arena.allocate(4096, 1));
+
+  ASSERT_NE(large, nullptr);
+
+  large[4095] = 1;
+
+  EXPECT_EQ(nullptr, arena.allocate(2 * pxd::memory::SIZE_1MB));
+}
+
+TEST(Arena, EasyMalloc)
+{
+  pxd::memory::MemoryPool      pool(pxd::memory::SIZE_1MB);
+  pxd::memory::monotonic_arena arena(pool, 1024);
+
+  auto* values = arena.easy_malloc<uint64_t>(4);
+
+  ASSERT_NE(values, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(values) % alignof(uint64_t));
+
+  EXPECT_EQ(nullptr,
+            arena.easy_malloc<uint64_t>(
+              (std::numeric_limits<size_t>::max() / sizeof(uint64_t)) + 2));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+/*
+ * the huge pages and numa nodes depend on the machine, so these tests only
+ * check that every option falls back to a working pool
+ */
+
+namespace {
+
+void
+check_pool(pxd::memory::MemoryPool& pool, size_t size)
+{
+  auto* block = static_cast<uint8_t*>(pool.calloc(size));
+
+  ASSERT_NE(block, nullptr);
+
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(0, block[i]);
+  }
+
+  std::memset(block, 0xAB, size);
+  pool.free(block);
+}
+
+} // namespace
+
+TEST(Backing, Default)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB);
+
+  const pxd::memory::PoolBacking backing = pool.backing();
+
+  EXPECT_GT(backing.page_size, 0U);
+  EXPECT_EQ(pxd::memory::HugePages::NONE, backing.huge_pages);
+  EXPECT_FALSE(backing.populated);
+  EXPECT_EQ(-1, backing.numa_node);
+
+  pool.release_memory();
+
+  EXPECT_EQ(0U, pool.backing().page_size);
+}
+
+TEST(Backing, TransparentHugePages)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.huge_pages               = pxd::memory::HugePages::TRANSPARENT;
+
+  pxd::memory::MemoryPool pool(4 * pxd::memory::SIZE_1MB, options);
+
+  const pxd::memory::PoolBacking backing = pool.backing();
+
+  EXPECT_NE(pxd::memory::HugePages::EXPLICIT, backing.huge_pages);
+
+  check_pool(pool, 4 * pxd::memory::SIZE_1MB);
+}
+
+TEST(Backing, ExplicitHugePages)
+{
+  pxd::memory::PoolOptions options = {};
+  options.huge_pages               = pxd::memory::HugePages::EXPLICIT;
+  options.max_size                 = 16 * pxd::memory::SIZE_1MB;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  const pxd::memory::PoolBacking backing = pool.backing();
+
+  if (backing.huge_pages == pxd::memory::HugePages::EXPLICIT) {
+    EXPECT_GE(backing.page_size, 2 * pxd::memory::SIZE_1MB);
+  }
+
+  check_pool(pool, pxd::memory::SIZE_1MB);
+  check_pool(pool, 8 * pxd::memory::SIZE_1MB);
+}
+
+TEST(Backing, Populate)
+{
+  pxd::memory::PoolOptions options = {};
+  options.populate                 = true;
+  options.max_size                 = 4 * pxd::memory::SIZE_1MB;
+  options.grow_size                = pxd::memory::SIZE_1MB;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  EXPECT_TRUE(pool.backing().populated);
+
+  check_pool(pool, pxd::memory::SIZE_1MB);
+  check_pool(pool, 3 * pxd::memory::SIZE_1MB);
+}
+
+TEST(Backing, NumaNode)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.numa_node                = 0;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  const int node = pool.backing().numa_node;
+
+  EXPECT_TRUE(node == 0 || node == -1);
+
+  check_pool(pool, pxd::memory::SIZE_1MB);
+}
+
+TEST(Backing, MissingNumaNode)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.numa_node                = 1 << 20;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  EXPECT_EQ(-1, pool.backing().numa_node);
+
+  check_pool(pool, pxd::memory::SIZE_1MB);
+}
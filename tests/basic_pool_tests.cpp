@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include "../includes/basic_pool.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace policy = pxd::memory::policy;
+
+template<class Pool>
+class BasicPool : public testing::Test
+{};
+
+using PoolTypes =
+  testing::Types<pxd::memory::basic_pool<policy::first_fit>,
+                 pxd::memory::basic_pool<policy::next_fit>,
+                 pxd::memory::basic_pool<policy::best_fit>,
+                 pxd::memory::basic_pool<policy::size_class_fit>,
+                 pxd::memory::basic_pool<policy::simd_first_fit>,
+                 pxd::memory::basic_pool<policy::best_fit,
+                                         policy::mutex_lock,
+                                         policy::zero_on_free,
+                                         policy::counting_stats>,
+                 pxd::memory::basic_pool<policy::size_class_fit,
+                                         policy::mutex_lock,
+                                         policy::zero_on_alloc,
+                                         policy::counting_stats>>;
+
+TYPED_TEST_SUITE(BasicPool, PoolTypes);
+
+TYPED_TEST(BasicPool, MallocFree)
+{
+  TypeParam pool(64 * pxd::memory::SIZE_1KB);
+
+  std::vector<void*> blocks;
+
+  for (size_t i = 0; i < 64; ++i) {
+    blocks.push_back(pool.malloc(1000));
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+
+  EXPECT_EQ(nullptr, pool.malloc(2 * pxd::memory::SIZE_1KB));
+
+  for (size_t i = 0; i < blocks.size(); i += 2) {
+    pool.free(blocks[i]);
+  }
+
+  EXPECT_EQ(nullptr, pool.malloc(2 * pxd::memory::SIZE_1KB));
+
+  for (size_t i = 1; i < blocks.size(); i += 2) {
+    pool.free(blocks[i]);
+  }
+
+  const pxd::memory::PoolStats stats = pool.stats();
+
+  EXPECT_EQ(64 * pxd::memory::SIZE_1KB, stats.free_bytes);
+  EXPECT_NE(nullptr, pool.malloc(64 * pxd::memory::SIZE_1KB));
+}
+
+TYPED_TEST(BasicPool, Aligned)
+{
+  TypeParam pool(64 * pxd::memory::SIZE_1KB);
+
+  void* unaligned = pool.malloc(3);
+
+  ASSERT_NE(unaligned, nullptr);
+
+  for (size_t alignment = 1; alignment <= 4096; alignment *= 2) {
+    void* ptr = pool.aligned_malloc(24, alignment);
+
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(ptr) % alignment);
+    EXPECT_EQ(24U, pool.usable_size(ptr));
+  }
+
+  EXPECT_EQ(nullptr, pool.aligned_malloc(24, 3));
+}
+
+TYPED_TEST(BasicPool, Calloc)
+{
+  TypeParam pool(16 * pxd::memory::SIZE_1KB);
+
+  auto* first = static_cast<uint8_t*>(pool.malloc(4 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(first, nullptr);
+
+  std::memset(first, 0xAB, 4 * pxd::memory::SIZE_1KB);
+  pool.free(first);
+
+  auto* second =
+    static_cast<uint8_t*>(pool.calloc(16 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(second, nullptr);
+
+  for (size_t i = 0; i < 16 * pxd::memory::SIZE_1KB; ++i) {
+    ASSERT_EQ(0, second[i]);
+  }
+}
+
+TYPED_TEST(BasicPool, Realloc)
+{
+  TypeParam pool(16 * pxd::memory::SIZE_1KB);
+
+  auto* block = static_cast<uint8_t*>(pool.malloc(100));
+
+  ASSERT_NE(block, nullptr);
+
+  for (size_t i = 0; i < 100; ++i) {
+    block[i] = static_cast<uint8_t>(i);
+  }
+
+  EXPECT_EQ(block, pool.realloc(block, 1000));
+  EXPECT_EQ(1000U, pool.usable_size(block));
+
+  void* blocker = pool.malloc(100);
+
+  ASSERT_NE(blocker, nullptr);
+
+  auto* moved = static_cast<uint8_t*>(pool.realloc(block, 2000));
+
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(block, moved);
+
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(static_cast<uint8_t>(i), moved[i]);
+  }
+
+  EXPECT_EQ(moved, pool.realloc(moved, 50));
+  EXPECT_EQ(50U, pool.usable_size(moved));
+  EXPECT_EQ(nullptr, pool.realloc(moved, 64 * pxd::memory::SIZE_1KB));
+  EXPECT_EQ(50U, pool.usable_size(moved));
+}
+
+TEST(BasicPoolStats, Counting)
+{
+  pxd::memory::basic_pool<policy::best_fit,
+                          policy::null_lock,
+                          policy::no_scrub,
+                          policy::counting_stats>
+    pool(pxd::memory::SIZE_1MB);
+
+  void* first  = pool.malloc(1000);
+  void* second = pool.malloc(2000);
+
+  EXPECT_EQ(nullptr, pool.malloc(2 * pxd::memory::SIZE_1MB));
+
+  pool.free(first);
+
+  const pxd::memory::PoolStats stats = pool.stats();
+
+  EXPECT_EQ(2000U, stats.allocated_bytes);
+  EXPECT_EQ(3000U, stats.peak_bytes);
+  EXPECT_EQ(2U, stats.alloc_count);
+  EXPECT_EQ(1U, stats.free_count);
+  EXPECT_EQ(1U, stats.failed_count);
+  EXPECT_EQ(pxd::memory::SIZE_1MB - 2000, stats.free_bytes);
+  EXPECT_EQ(pxd::memory::SIZE_1MB - 3000, stats.largest_free_block);
+  EXPECT_EQ(1000U, stats.smallest_free_block);
+
+  pool.free(second);
+}
+
+TEST(BasicPoolStats, NullPoliciesTakeNoSpace)
+{
+  using LeanPool = pxd::memory::basic_pool<policy::first_fit>;
+  using FullPool = pxd::memory::basic_pool<policy::first_fit,
+                                           policy::mutex_lock,
+                                           policy::no_scrub,
+                                           policy::counting_stats>;
+
+  EXPECT_LT(sizeof(LeanPool), sizeof(FullPool));
+  EXPECT_EQ(0U, LeanPool(pxd::memory::SIZE_1KB).stats().alloc_count);
+}
+
+TEST(BasicPoolStats, MutexLock)
+{
+  pxd::memory::basic_pool<policy::size_class_fit,
+                          policy::mutex_lock,
+                          policy::no_scrub,
+                          policy::counting_stats>
+    pool(16 * pxd::memory::SIZE_1MB);
+
+  std::vector<std::thread> threads;
+
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&pool]() {
+      for (size_t i = 0; i < 2000; ++i) {
+        void* ptr = pool.malloc(16 + (i % 512));
+
+        ASSERT_NE(ptr, nullptr);
+        pool.free(ptr);
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const pxd::memory::PoolStats stats = pool.stats();
+
+  EXPECT_EQ(8000U, stats.alloc_count);
+  EXPECT_EQ(0U, stats.allocated_bytes);
+  EXPECT_EQ(16 * pxd::memory::SIZE_1MB, stats.largest_free_block);
+}
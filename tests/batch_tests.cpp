@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <array>
+#include <cstdint>
+#include <thread>
+
+TEST(Batch, SingleFit)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(128);
+
+  std::array<void*, 4> blocks = {};
+
+  ASSERT_TRUE(pool.malloc_batch(16, blocks.size(), blocks.data()));
+
+  for (size_t i = 1; i < blocks.size(); i++) {
+    EXPECT_EQ(static_cast<uint8_t*>(blocks[i - 1]) + 16, blocks[i]);
+  }
+
+  EXPECT_EQ(64, pool.total_allocated_memory());
+  EXPECT_EQ(4, pool.stats().alloc_count);
+
+  pool.free(blocks[1]);
+
+  EXPECT_EQ(48, pool.total_allocated_memory());
+
+  pool.free_batch(blocks.data(), blocks.size());
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+  EXPECT_EQ(128, pool.max_free_memory());
+  EXPECT_EQ(4, pool.stats().free_count);
+}
+
+TEST(Batch, Fragmented)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(128);
+
+  std::array<void*, 8> filler = {};
+
+  ASSERT_TRUE(pool.malloc_batch(16, filler.size(), filler.data()));
+
+  for (size_t i = 0; i < filler.size(); i += 2) {
+    pool.free(filler[i]);
+  }
+
+  std::array<void*, 4> blocks = {};
+
+  ASSERT_TRUE(pool.malloc_batch(16, blocks.size(), blocks.data()));
+
+  EXPECT_EQ(128, pool.total_allocated_memory());
+
+  std::array<void*, 2> too_many = {};
+
+  EXPECT_FALSE(pool.malloc_batch(16, too_many.size(), too_many.data()));
+  EXPECT_EQ(128, pool.total_allocated_memory());
+  EXPECT_EQ(1, pool.stats().failed_count);
+
+  pool.free_batch(blocks.data(), blocks.size());
+
+  EXPECT_EQ(64, pool.total_allocated_memory());
+  EXPECT_EQ(16, pool.max_free_memory());
+}
+
+TEST(Batch, InvalidArguments)
+{
+  pxd::memory::MemoryPool pool(128);
+
+  std::array<void*, 2> blocks = {};
+
+  EXPECT_TRUE(pool.malloc_batch(16, 0, blocks.data()));
+  EXPECT_FALSE(pool.malloc_batch(0, 2, blocks.data()));
+  EXPECT_FALSE(pool.malloc_batch(SIZE_MAX, 2, blocks.data()));
+  EXPECT_FALSE(pool.malloc_batch(16, 2, nullptr));
+
+  std::array<void*, 3> foreign = { nullptr, &blocks, nullptr };
+
+  pool.free_batch(foreign.data(), foreign.size());
+
+  EXPECT_EQ(128, pool.total_free_memory());
+}
+
+TEST(Batch, ThreadCaches)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  std::array<void*, 4> blocks = {
+    pool.malloc(32), pool.malloc(32), pool.malloc(1024), nullptr
+  };
+
+  ASSERT_TRUE(pool.malloc_batch(64, 1, &blocks[3]));
+
+  std::thread remote(
+    [&pool, &blocks]() { pool.free_batch(blocks.data(), blocks.size()); });
+
+  remote.join();
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+}
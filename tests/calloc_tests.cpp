@@ -2,6 +2,9 @@
 
 #include "../includes/memory_pool.hpp"
 
+#include <cstdint>
+#include <limits>
+
 TEST(Calloc, Array) {
   pxd::memory::alloc_memory(128);
 
@@ -33,3 +36,22 @@ TEST(Calloc, Easy) {
 
   pxd::memory::release_memory();
 }
+
+TEST(Calloc, EasyAlignmentAndOverflow)
+{
+  pxd::memory::alloc_memory(256);
+
+  void* padding = pxd::memory::malloc(1);
+  auto* temp    = pxd::memory::easy_calloc<uint64_t>(4);
+
+  ASSERT_NE(temp, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(temp) % alignof(uint64_t));
+
+  EXPECT_EQ(nullptr,
+            pxd::memory::easy_calloc<uint64_t>(
+              (std::numeric_limits<size_t>::max() / sizeof(uint64_t)) + 1));
+
+  pxd::memory::free(temp);
+  pxd::memory::free(padding);
+  pxd::memory::release_memory();
+}
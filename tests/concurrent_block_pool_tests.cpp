@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include "../includes/concurrent_block_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentBlockPool, AllocateAll)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB);
+
+  {
+    pxd::memory::concurrent_block_pool blocks(pool, 100, 64, 64);
+
+    EXPECT_EQ(128U, blocks.block_size());
+
+    std::vector<void*> allocated;
+
+    for (size_t i = 0; i < 64; ++i) {
+      allocated.push_back(blocks.allocate());
+
+      ASSERT_NE(allocated.back(), nullptr);
+      EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(allocated.back()) % 64);
+      EXPECT_TRUE(blocks.owns(allocated.back()));
+
+      std::memset(allocated.back(), static_cast<int>(i), 100);
+    }
+
+    EXPECT_EQ(nullptr, blocks.allocate());
+
+    blocks.deallocate(allocated[10]);
+
+    EXPECT_EQ(allocated[10], blocks.allocate());
+
+    for (void* block : allocated) {
+      blocks.deallocate(block);
+    }
+
+    EXPECT_NE(nullptr, blocks.allocate());
+    EXPECT_EQ(64 * 128U, pool.total_allocated_memory());
+  }
+
+  EXPECT_EQ(0U, pool.total_allocated_memory());
+}
+
+TEST(ConcurrentBlockPool, FullMemoryPool)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1KB);
+
+  EXPECT_THROW(pxd::memory::concurrent_block_pool(pool, 64, 1024),
+               std::bad_alloc);
+  EXPECT_THROW(pxd::memory::concurrent_block_pool(pool, 64, 0),
+               std::bad_alloc);
+}
+
+TEST(ConcurrentBlockPool, SizeOverflow)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1KB);
+
+  const size_t max_size = std::numeric_limits<size_t>::max();
+
+  EXPECT_THROW(pxd::memory::concurrent_block_pool(pool, (max_size / 4) + 1, 4),
+               std::bad_alloc);
+  EXPECT_THROW(pxd::memory::concurrent_block_pool(pool, max_size, 1),
+               std::bad_alloc);
+}
+
+/*
+ * producers allocate blocks, stamp them and hand them to consumers which
+ * check and free them. a block handed out twice at the same time trips the
+ * in use flags
+ */
+TEST(ConcurrentBlockPool, ProducerConsumerStress)
+{
+  constexpr size_t BLOCK_COUNT    = 256;
+  constexpr size_t PRODUCER_COUNT = 4;
+  constexpr size_t CONSUMER_COUNT = 4;
+  constexpr size_t MESSAGE_COUNT  = 20000;
+
+  pxd::memory::MemoryPool            pool(pxd::memory::SIZE_1MB);
+  pxd::memory::concurrent_block_pool blocks(pool, 64, BLOCK_COUNT);
+
+  std::vector<std::atomic<bool>> in_use(BLOCK_COUNT);
+  std::atomic<size_t>            double_allocations = 0;
+  std::atomic<size_t>            corrupted          = 0;
+  std::atomic<size_t>            consumed           = 0;
+
+  std::mutex        queue_mutex;
+  std::deque<void*> queue;
+  std::atomic<bool> producing = true;
+
+  /*
+   * the first block of a fresh pool is the start of its region
+   */
+  auto* base = static_cast<uint8_t*>(blocks.allocate());
+  blocks.deallocate(base);
+
+  const auto block_index = [&](void* block) {
+    return static_cast<size_t>(static_cast<uint8_t*>(block) - base) /
+           blocks.block_size();
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t p = 0; p < PRODUCER_COUNT; ++p) {
+    threads.emplace_back([&, p]() {
+      for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+        void* block = blocks.allocate();
+
+        while (block == nullptr) {
+          std::this_thread::yield();
+          block = blocks.allocate();
+        }
+
+        if (in_use[block_index(block)].exchange(true)) {
+          double_allocations++;
+        }
+
+        const uint64_t stamp = (p << 32) | i;
+        std::memcpy(block, &stamp, sizeof(stamp));
+        std::memcpy(static_cast<uint8_t*>(block) + 56, &stamp, sizeof(stamp));
+
+        const std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(block);
+      }
+    });
+  }
+
+  for (size_t c = 0; c < CONSUMER_COUNT; ++c) {
+    threads.emplace_back([&]() {
+      while (true) {
+        void* block = nullptr;
+
+        {
+          const std::lock_guard<std::mutex> lock(queue_mutex);
+
+          if (!queue.empty()) {
+            block = queue.front();
+            queue.pop_front();
+          }
+        }
+
+        if (block == nullptr) {
+          if (!producing && consumed == PRODUCER_COUNT * MESSAGE_COUNT) {
+            return;
+          }
+
+          std::this_thread::yield();
+          continue;
+        }
+
+        uint64_t front = 0;
+        uint64_t back  = 0;
+        std::memcpy(&front, block, sizeof(front));
+        std::memcpy(&back, static_cast<uint8_t*>(block) + 56, sizeof(back));
+
+        if (front != back) {
+          corrupted++;
+        }
+
+        in_use[block_index(block)].store(false);
+        blocks.deallocate(block);
+        consumed++;
+      }
+    });
+  }
+
+  for (size_t p = 0; p < PRODUCER_COUNT; ++p) {
+    threads[p].join();
+  }
+
+  producing = false;
+
+  for (size_t c = 0; c < CONSUMER_COUNT; ++c) {
+    threads[PRODUCER_COUNT + c].join();
+  }
+
+  EXPECT_EQ(0U, double_allocations.load());
+  EXPECT_EQ(0U, corrupted.load());
+  EXPECT_EQ(PRODUCER_COUNT * MESSAGE_COUNT, consumed.load());
+
+  std::vector<void*> allocated;
+
+  for (void* block = blocks.allocate(); block != nullptr;
+       block       = blocks.allocate()) {
+    allocated.push_back(block);
+  }
+
+  EXPECT_EQ(BLOCK_COUNT, allocated.size());
+}
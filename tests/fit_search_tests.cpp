@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../includes/basic_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr pxd::memory::SimdLevel LEVELS[] = {
+  pxd::memory::SimdLevel::SCALAR,
+  pxd::memory::SimdLevel::SSE4_2,
+  pxd::memory::SimdLevel::AVX2,
+  pxd::memory::SimdLevel::AVX512,
+};
+
+} // namespace
+
+TEST(FitSearch, EveryPosition)
+{
+  for (const pxd::memory::SimdLevel level : LEVELS) {
+    for (size_t count = 0; count < 40; ++count) {
+      std::vector<size_t> sizes(count, 16);
+
+      EXPECT_EQ(count,
+                pxd::memory::find_first_at_least(
+                  sizes.data(), sizes.size(), 17, level));
+
+      for (size_t position = 0; position < count; ++position) {
+        sizes[position] = 17;
+
+        EXPECT_EQ(position,
+                  pxd::memory::find_first_at_least(
+                    sizes.data(), sizes.size(), 17, level));
+        EXPECT_EQ(position,
+                  pxd::memory::find_first_at_least(
+                    sizes.data(), sizes.size(), 17));
+
+        sizes[position] = 16;
+      }
+    }
+  }
+}
+
+TEST(FitSearch, UnsignedCompare)
+{
+  const size_t huge = std::numeric_limits<size_t>::max() - 3;
+
+  std::vector<size_t> sizes = { 1, 2, 3, huge, 5, 6, 7, 8, huge, 10 };
+
+  for (const pxd::memory::SimdLevel level : LEVELS) {
+    EXPECT_EQ(3U,
+              pxd::memory::find_first_at_least(
+                sizes.data(), sizes.size(), size_t{ 1 } << 63, level));
+    EXPECT_EQ(sizes.size(),
+              pxd::memory::find_first_at_least(
+                sizes.data(), sizes.size(), huge + 1, level));
+    EXPECT_EQ(0U,
+              pxd::memory::find_first_at_least(
+                sizes.data(), sizes.size(), 0, level));
+  }
+}
@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
 #include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
 
 TEST(Free, Array)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp = pxd::memory::malloc(30);
@@ -19,6 +22,8 @@ TEST(Free, Array)
 
 TEST(Free, PrevMemory)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp   = pxd::memory::malloc(10);
@@ -37,6 +42,8 @@ TEST(Free, PrevMemory)
 
 TEST(Free, NextMemory)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp   = pxd::memory::malloc(10);
@@ -60,6 +67,8 @@ TEST(Free, NextMemory)
 
 TEST(Free, NextMemory2)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp   = pxd::memory::malloc(10);
@@ -85,6 +94,8 @@ TEST(Free, NextMemory2)
 
 TEST(Free, MiddleMemory)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp   = pxd::memory::malloc(10);
@@ -112,6 +123,8 @@ TEST(Free, MiddleMemory)
 
 TEST(Free, MiddleMemory2)
 {
+  PXD_SKIP_IF_HARDENED();
+
   pxd::memory::alloc_memory(128);
 
   void* temp   = pxd::memory::malloc(10);
@@ -139,3 +152,111 @@ TEST(Free, MiddleMemory2)
 
   pxd::memory::release_memory();
 }
+
+TEST(Free, InvalidPointer)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  auto* temp    = static_cast<uint8_t*>(pxd::memory::malloc(10));
+  int   outside = 0;
+
+  pxd::memory::free(nullptr);
+  pxd::memory::free(temp + 1);
+  pxd::memory::free(&outside);
+
+  EXPECT_EQ(10, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(118, pxd::memory::total_free_memory());
+
+  pxd::memory::free(temp);
+  pxd::memory::free(temp);
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(128, pxd::memory::total_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Free, ManyFragments)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(1024);
+
+  void* blocks[64] = {};
+
+  for (auto& block : blocks) {
+    block = pxd::memory::malloc(16);
+  }
+
+  for (size_t i = 0; i < 64; i += 2) {
+    pxd::memory::free(blocks[i]);
+  }
+
+  EXPECT_EQ(512, pxd::memory::total_free_memory());
+  EXPECT_EQ(16, pxd::memory::max_free_memory());
+
+  for (size_t i = 1; i < 64; i += 2) {
+    pxd::memory::free(blocks[i]);
+  }
+
+  EXPECT_EQ(1024, pxd::memory::total_free_memory());
+  EXPECT_EQ(1024, pxd::memory::max_free_memory());
+  EXPECT_EQ(1024, pxd::memory::min_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Free, Sized)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  void* temp   = pxd::memory::malloc(10);
+  void* temp_2 = pxd::memory::malloc(20);
+  void* temp_3 = pxd::memory::malloc(30);
+
+  pxd::memory::free(temp_2, 20);
+
+  EXPECT_EQ(88, pxd::memory::total_free_memory());
+  EXPECT_EQ(68, pxd::memory::max_free_memory());
+
+  pxd::memory::free(temp_2, 20);
+
+  EXPECT_EQ(88, pxd::memory::total_free_memory());
+
+  pxd::memory::free(temp, 10);
+  pxd::memory::free(temp_3, 0);
+
+  EXPECT_EQ(128, pxd::memory::total_free_memory());
+  EXPECT_EQ(128, pxd::memory::max_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Free, SizedWrongSize)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  void* temp   = pxd::memory::malloc(10);
+  void* temp_2 = pxd::memory::malloc(20);
+  void* temp_3 = pxd::memory::malloc(30);
+
+  pxd::memory::free(temp_2, 50);
+
+  EXPECT_EQ(40, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(68, pxd::memory::max_free_memory());
+  EXPECT_EQ(20, pxd::memory::min_free_memory());
+
+  pxd::memory::free(temp, 4);
+  pxd::memory::free(temp_3, 30);
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(128, pxd::memory::max_free_memory());
+
+  pxd::memory::release_memory();
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST(Grow, GrowsOnDemand)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.max_size                 = pxd::memory::SIZE_1MB;
+  options.grow_size                = 64 * pxd::memory::SIZE_1KB;
+
+  pxd::memory::MemoryPool pool(64 * pxd::memory::SIZE_1KB, options);
+
+  auto* first = static_cast<uint8_t*>(pool.malloc(60 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(first, nullptr);
+
+  first[0] = 42;
+
+  auto* second =
+    static_cast<uint8_t*>(pool.malloc(100 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(second, nullptr);
+
+  second[100 * pxd::memory::SIZE_1KB - 1] = 24;
+
+  EXPECT_EQ(42, first[0]);
+  EXPECT_EQ(160 * pxd::memory::SIZE_1KB, pool.total_allocated_memory());
+  EXPECT_EQ(192 * pxd::memory::SIZE_1KB,
+            pool.total_allocated_memory() + pool.total_free_memory());
+
+  pool.free(first);
+  pool.free(second);
+
+  EXPECT_EQ(192 * pxd::memory::SIZE_1KB, pool.max_free_memory());
+}
+
+TEST(Grow, MaxSize)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.max_size                 = 256 * pxd::memory::SIZE_1KB;
+
+  pxd::memory::MemoryPool pool(64 * pxd::memory::SIZE_1KB, options);
+
+  EXPECT_EQ(nullptr, pool.malloc(pxd::memory::SIZE_1MB));
+
+  std::vector<void*> blocks;
+
+  for (size_t i = 0; i < 4; ++i) {
+    blocks.push_back(pool.malloc(64 * pxd::memory::SIZE_1KB));
+    EXPECT_NE(blocks.back(), nullptr);
+  }
+
+  EXPECT_EQ(nullptr, pool.malloc(1));
+}
+
+TEST(Grow, ReleaseFreeChunks)
+{
+  pxd::memory::PoolOptions options = {};
+  options.max_size                 = pxd::memory::SIZE_1MB;
+  options.grow_size                = 64 * pxd::memory::SIZE_1KB;
+  options.release_free_chunks      = true;
+
+  pxd::memory::MemoryPool pool(64 * pxd::memory::SIZE_1KB, options);
+
+  void* temp = pool.malloc(300 * pxd::memory::SIZE_1KB);
+
+  ASSERT_NE(temp, nullptr);
+
+  pool.free(temp);
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+
+  auto* reused =
+    static_cast<uint8_t*>(pool.calloc(300 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(reused, nullptr);
+
+  for (size_t i = 0; i < 300 * pxd::memory::SIZE_1KB; i += 4096) {
+    EXPECT_EQ(0, reused[i]);
+  }
+
+  pool.free(reused);
+}
@@ -0,0 +1,408 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define PXD_TEST_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define PXD_TEST_ASAN 1
+#endif
+#endif
+
+#if defined(PXD_TEST_ASAN)
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace {
+
+std::vector<pxd::memory::CorruptionReport> reports;
+
+void
+record_report(const pxd::memory::CorruptionReport& report)
+{
+  reports.push_back(report);
+}
+
+void
+other_handler(const pxd::memory::CorruptionReport& /*report*/)
+{
+}
+
+} // namespace
+
+TEST(Hardened, SetHandler)
+{
+  EXPECT_EQ(nullptr, pxd::memory::set_corruption_handler(record_report));
+  EXPECT_EQ(record_report, pxd::memory::set_corruption_handler(other_handler));
+  EXPECT_EQ(other_handler, pxd::memory::set_corruption_handler(nullptr));
+}
+
+#if defined(PXD_HARDENED)
+
+/*
+ * the reports are recorded instead of aborting, so the tests can check them
+ */
+class HardenedPool : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    reports.clear();
+    pxd::memory::set_corruption_handler(record_report);
+  }
+
+  void TearDown() override { pxd::memory::set_corruption_handler(nullptr); }
+
+  pxd::memory::MemoryPool m_pool{ 1024 };
+};
+
+TEST_F(HardenedPool, Guards)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.aligned_malloc(40, 64));
+
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block) % 64);
+  EXPECT_EQ(40, m_pool.usable_size(block));
+
+  std::memset(block, 0xAB, 40);
+  m_pool.free(block);
+
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST_F(HardenedPool, DoubleFree)
+{
+  void* block = m_pool.malloc(32);
+
+  m_pool.free(block);
+  m_pool.free(block);
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::DOUBLE_FREE, reports[0].kind);
+  EXPECT_EQ(block, reports[0].pointer);
+  EXPECT_EQ(0, reports[0].start_index);
+  EXPECT_EQ(1024, reports[0].total_size);
+}
+
+TEST_F(HardenedPool, InteriorFree)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  m_pool.free(block + 8);
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::INVALID_FREE, reports[0].kind);
+  EXPECT_EQ(block + 8, reports[0].pointer);
+  EXPECT_EQ(32, reports[0].total_size);
+
+  EXPECT_EQ(nullptr, m_pool.realloc(block + 8, 64));
+  ASSERT_EQ(2, reports.size());
+  EXPECT_EQ(reports[0].start_index, reports[1].start_index);
+
+  m_pool.free(block);
+
+  EXPECT_EQ(2, reports.size());
+}
+
+TEST_F(HardenedPool, FreedPattern)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  std::memset(block, 0xAB, 32);
+  m_pool.free(block);
+
+  auto* reused = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  ASSERT_EQ(block, reused);
+
+  for (size_t i = 0; i < 32; i++) {
+    EXPECT_EQ(0xDD, reused[i]);
+  }
+
+  m_pool.free(reused);
+}
+
+TEST_F(HardenedPool, StatsWithoutGuards)
+{
+  void* block = m_pool.malloc(40);
+
+  ASSERT_NE(block, nullptr);
+
+  pxd::memory::PoolStats stats = m_pool.stats();
+
+  EXPECT_EQ(40, stats.allocated_bytes);
+  EXPECT_EQ(952, stats.free_bytes);
+
+  pxd::memory::PoolSnapshot snapshot = m_pool.snapshot();
+
+  EXPECT_EQ(1, snapshot.allocated_histogram[5]);
+  EXPECT_EQ(952, snapshot.largest_free_block);
+  EXPECT_EQ(920, snapshot.largest_aligned_block[0]);
+
+  block = m_pool.realloc(block, 64);
+  stats = m_pool.stats();
+
+  EXPECT_EQ(64, m_pool.usable_size(block));
+  EXPECT_EQ(64, stats.allocated_bytes);
+  EXPECT_EQ(64, stats.peak_bytes);
+
+  m_pool.free(block);
+  stats = m_pool.stats();
+
+  EXPECT_EQ(0, stats.allocated_bytes);
+  EXPECT_EQ(1024, stats.free_bytes);
+  EXPECT_EQ(992, m_pool.snapshot().largest_aligned_block[0]);
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST_F(HardenedPool, Layout)
+{
+  using pxd::memory::test::GUARDS;
+
+  auto* block   = static_cast<uint8_t*>(m_pool.malloc(16));
+  auto* block_2 = static_cast<uint8_t*>(m_pool.malloc(16));
+
+  EXPECT_EQ(block + 16 + GUARDS, block_2);
+  EXPECT_EQ(1024 - 32 - (2 * GUARDS), m_pool.total_free_memory());
+
+  void* blocks[4] = {};
+
+  ASSERT_TRUE(m_pool.malloc_batch(16, 4, blocks));
+
+  for (size_t i = 1; i < 4; i++) {
+    EXPECT_EQ(static_cast<uint8_t*>(blocks[i - 1]) + 16 + GUARDS, blocks[i]);
+  }
+
+  m_pool.free_batch(blocks, 4);
+  m_pool.free(block_2);
+  m_pool.free(block);
+
+  EXPECT_EQ(1024, m_pool.max_free_memory());
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST_F(HardenedPool, SizedFree)
+{
+  void* block   = m_pool.malloc(10);
+  void* block_2 = m_pool.malloc(20);
+
+  m_pool.free(block_2, 50);
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::INVALID_FREE, reports[0].kind);
+  EXPECT_EQ(20, reports[0].total_size);
+  EXPECT_EQ(10, m_pool.total_allocated_memory());
+
+  m_pool.free(block_2, 20);
+
+  ASSERT_EQ(2, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::DOUBLE_FREE, reports[1].kind);
+
+  m_pool.free(block, 10);
+
+  EXPECT_EQ(0, m_pool.total_allocated_memory());
+  EXPECT_EQ(1024, m_pool.max_free_memory());
+  EXPECT_EQ(2, reports.size());
+}
+
+TEST_F(HardenedPool, CountersSkipReportedFrees)
+{
+  void* block = m_pool.malloc(32);
+
+  m_pool.free(block);
+  m_pool.free(block);
+
+  const pxd::memory::PoolStats stats = m_pool.stats();
+
+  EXPECT_EQ(1, reports.size());
+  EXPECT_EQ(1, stats.alloc_count);
+  EXPECT_EQ(1, stats.free_count);
+  EXPECT_EQ(0, stats.allocated_bytes);
+  EXPECT_EQ(1024, stats.free_bytes);
+}
+
+TEST_F(HardenedPool, LargestAlignedBlock)
+{
+  void* block = m_pool.malloc(100);
+
+  const size_t largest = m_pool.snapshot().largest_aligned_block[6];
+
+  EXPECT_EQ(nullptr, m_pool.aligned_malloc(largest + 1, 64));
+
+  void* aligned = m_pool.aligned_malloc(largest, 64);
+
+  EXPECT_NE(nullptr, aligned);
+
+  m_pool.free(aligned);
+  m_pool.free(block);
+
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST_F(HardenedPool, Grow)
+{
+  pxd::memory::PoolOptions options = {};
+  options.max_size                 = pxd::memory::SIZE_1MB;
+  options.grow_size                = 64 * pxd::memory::SIZE_1KB;
+
+  pxd::memory::MemoryPool pool(64 * pxd::memory::SIZE_1KB, options);
+
+  auto* first = static_cast<uint8_t*>(pool.malloc(60 * pxd::memory::SIZE_1KB));
+  auto* second =
+    static_cast<uint8_t*>(pool.malloc(100 * pxd::memory::SIZE_1KB));
+
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+
+  std::memset(first, 0xAB, 60 * pxd::memory::SIZE_1KB);
+  std::memset(second, 0xAB, 100 * pxd::memory::SIZE_1KB);
+
+  EXPECT_EQ(160 * pxd::memory::SIZE_1KB, pool.total_allocated_memory());
+
+  pool.free(first);
+  pool.free(second);
+
+  EXPECT_EQ(pool.total_free_memory(), pool.max_free_memory());
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST_F(HardenedPool, ScrubOverFreedPattern)
+{
+  pxd::memory::PoolOptions options = {};
+  options.scrub                    = pxd::memory::ScrubMode::ZERO_ON_FREE;
+
+  pxd::memory::MemoryPool pool(1024, options);
+
+  auto* dirty = static_cast<uint8_t*>(pool.malloc(128));
+
+  std::memset(dirty, 0xAB, 128);
+  pool.free(dirty);
+
+  auto* reused = static_cast<uint8_t*>(pool.malloc(128));
+
+  ASSERT_EQ(dirty, reused);
+
+  for (size_t i = 0; i < 128; i++) {
+    EXPECT_EQ(0, reused[i]);
+  }
+
+  pool.free(reused);
+
+  EXPECT_TRUE(reports.empty());
+}
+
+TEST(HardenedDeathTest, DefaultHandlerAborts)
+{
+  pxd::memory::MemoryPool pool(256);
+
+  void* block = pool.malloc(32);
+
+  pool.free(block);
+
+  EXPECT_DEATH(pool.free(block), "double free");
+}
+
+/*
+ * asan reports the writes into the guards itself, before the pool can
+ */
+#if !defined(PXD_TEST_ASAN)
+TEST_F(HardenedPool, Overflow)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  m_pool.free(block + 1);
+
+  block[32] = 0;
+  m_pool.free(block);
+
+  ASSERT_EQ(2, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::BUFFER_OVERFLOW, reports[1].kind);
+  EXPECT_EQ(block + 32, reports[1].pointer);
+  EXPECT_EQ(reports[0].start_index, reports[1].start_index);
+  EXPECT_EQ(32, reports[1].total_size);
+}
+
+TEST_F(HardenedPool, Underflow)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  block[-1] = 0;
+  m_pool.free(block);
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::BUFFER_OVERFLOW, reports[0].kind);
+  EXPECT_EQ(block - 1, reports[0].pointer);
+}
+
+TEST_F(HardenedPool, ReallocChecksAndMovesGuards)
+{
+  auto* block = static_cast<uint8_t*>(m_pool.malloc(32));
+
+  block[32] = 0;
+  block     = static_cast<uint8_t*>(m_pool.realloc(block, 16));
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::BUFFER_OVERFLOW, reports[0].kind);
+
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(16, m_pool.usable_size(block));
+
+  void* blocker = m_pool.malloc(8);
+
+  block = static_cast<uint8_t*>(m_pool.realloc(block, 64));
+
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(64, m_pool.usable_size(block));
+
+  std::memset(block, 0xAB, 64);
+  m_pool.free(block);
+  m_pool.free(blocker);
+
+  EXPECT_EQ(1, reports.size());
+}
+
+TEST_F(HardenedPool, Batch)
+{
+  void* blocks[4] = {};
+
+  ASSERT_TRUE(m_pool.malloc_batch(24, 4, blocks));
+
+  static_cast<uint8_t*>(blocks[2])[24] = 0;
+
+  m_pool.free_batch(blocks, 4);
+
+  ASSERT_EQ(1, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::BUFFER_OVERFLOW, reports[0].kind);
+  EXPECT_EQ(static_cast<uint8_t*>(blocks[2]) + 24, reports[0].pointer);
+  EXPECT_EQ(24, reports[0].total_size);
+
+  m_pool.free_batch(blocks, 1);
+
+  ASSERT_EQ(2, reports.size());
+  EXPECT_EQ(pxd::memory::Corruption::DOUBLE_FREE, reports[1].kind);
+}
+#endif
+
+#endif
+
+#if defined(PXD_TEST_ASAN)
+TEST(Hardened, AsanPoisonsFreeBlocks)
+{
+  pxd::memory::MemoryPool pool(256);
+
+  auto* block = static_cast<uint8_t*>(pool.malloc(64));
+
+  EXPECT_EQ(0, __asan_region_is_poisoned(block, 64));
+  EXPECT_EQ(1, __asan_address_is_poisoned(block + 128));
+
+  pool.free(block);
+
+  EXPECT_EQ(1, __asan_address_is_poisoned(block));
+}
+#endif
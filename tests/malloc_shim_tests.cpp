@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+TEST(MallocShim, Malloc)
+{
+  void* temp = std::malloc(100);
+
+  ASSERT_NE(temp, nullptr);
+  EXPECT_TRUE(pxd::memory::default_pool().owns(temp));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(temp) % alignof(std::max_align_t));
+  EXPECT_LE(100, malloc_usable_size(temp));
+
+  std::free(temp);
+
+  void* empty = std::malloc(0);
+
+  EXPECT_NE(empty, nullptr);
+
+  std::free(empty);
+}
+
+TEST(MallocShim, Calloc)
+{
+  auto* dirty = static_cast<uint8_t*>(std::malloc(512));
+
+  ASSERT_NE(dirty, nullptr);
+
+  std::memset(dirty, 0xAB, 512);
+  std::free(dirty);
+
+  auto* clean = static_cast<uint8_t*>(std::calloc(64, 8));
+
+  ASSERT_NE(clean, nullptr);
+
+  for (size_t i = 0; i < 512; i++) {
+    ASSERT_EQ(0, clean[i]);
+  }
+
+  std::free(clean);
+
+  EXPECT_EQ(nullptr, std::calloc(SIZE_MAX / 2, 4));
+}
+
+TEST(MallocShim, Realloc)
+{
+  auto* temp = static_cast<uint8_t*>(std::malloc(16));
+
+  ASSERT_NE(temp, nullptr);
+
+  std::memset(temp, 7, 16);
+
+  temp = static_cast<uint8_t*>(std::realloc(temp, 4096));
+
+  ASSERT_NE(temp, nullptr);
+  EXPECT_EQ(7, temp[15]);
+
+  temp[4095] = 1;
+
+  std::free(std::realloc(temp, 0));
+}
+
+TEST(MallocShim, Aligned)
+{
+  void* temp = nullptr;
+
+  ASSERT_EQ(0, posix_memalign(&temp, 4096, 100));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(temp) % 4096);
+  EXPECT_TRUE(pxd::memory::default_pool().owns(temp));
+
+  std::free(temp);
+
+  EXPECT_EQ(EINVAL, posix_memalign(&temp, 3, 100));
+
+  void* aligned = std::aligned_alloc(256, 512);
+
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 256);
+
+  std::free(aligned);
+}
+
+TEST(MallocShim, Threads)
+{
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < 4; i++) {
+    threads.emplace_back([]() {
+      std::vector<void*> blocks;
+
+      for (size_t j = 0; j < 1000; j++) {
+        blocks.push_back(std::malloc((j % 300) + 1));
+      }
+
+      for (void* block : blocks) {
+        std::free(block);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/*
+ * the other thread keeps taking the lock of the pool, a child forked while it
+ * holds it would hang on its first malloc. the alarm turns a hang into a
+ * failure
+ */
+TEST(MallocShim, Fork)
+{
+  std::atomic<bool> is_running = true;
+
+  std::thread churn([&is_running]() {
+    while (is_running.load(std::memory_order_relaxed)) {
+      std::free(std::malloc(4096));
+    }
+  });
+
+  for (size_t i = 0; i < 50; i++) {
+    const pid_t pid = fork();
+
+    ASSERT_NE(-1, pid);
+
+    if (pid == 0) {
+      alarm(5);
+
+      void*      temp     = std::malloc(4096);
+      const bool is_owned = pxd::memory::default_pool().owns(temp);
+
+      std::free(temp);
+      _exit(is_owned ? 0 : 1);
+    }
+
+    int status = 0;
+
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+  }
+
+  is_running.store(false, std::memory_order_relaxed);
+  churn.join();
+}
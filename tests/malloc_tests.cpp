@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <limits>
 
 #define MEMORY_POOL_DEFAULT_SIZE 128
 
@@ -114,3 +118,73 @@ TEST(Malloc, Easy) {
 
   pxd::memory::release_memory();
 }
+
+TEST(Malloc, EasyAlignmentAndOverflow)
+{
+  pxd::memory::alloc_memory(256);
+
+  void* padding = pxd::memory::malloc(1);
+  auto* temp    = pxd::memory::easy_malloc<uint64_t>(4);
+
+  ASSERT_NE(temp, nullptr);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(temp) % alignof(uint64_t));
+
+  EXPECT_EQ(nullptr,
+            pxd::memory::easy_malloc<uint64_t>(
+              (std::numeric_limits<size_t>::max() / sizeof(uint64_t)) + 1));
+
+  pxd::memory::free(temp);
+  pxd::memory::free(padding);
+  pxd::memory::release_memory();
+}
+
+TEST(Malloc, BestFit)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(MEMORY_POOL_DEFAULT_SIZE);
+
+  void* temp   = pxd::memory::malloc(40);
+  void* temp_2 = pxd::memory::malloc(10);
+  void* temp_3 = pxd::memory::malloc(20);
+  void* temp_4 = pxd::memory::malloc(10);
+
+  pxd::memory::free(temp);
+  pxd::memory::free(temp_3);
+
+  void* temp_5 = pxd::memory::malloc(16);
+
+  EXPECT_EQ(temp_5, temp_3);
+  EXPECT_EQ(4, pxd::memory::min_free_memory());
+  EXPECT_EQ(48, pxd::memory::max_free_memory());
+
+  void* temp_6 = pxd::memory::malloc(41);
+
+  EXPECT_NE(temp_6, nullptr);
+  EXPECT_NE(temp_6, temp);
+
+  pxd::memory::release_memory();
+}
+
+TEST(Malloc, ZeroSize)
+{
+  pxd::memory::alloc_memory(256);
+
+  void* temp   = pxd::memory::malloc(0);
+  void* temp_2 = pxd::memory::malloc(0);
+  void* temp_3 = pxd::memory::calloc(0);
+
+  ASSERT_NE(temp, nullptr);
+  ASSERT_NE(temp_2, nullptr);
+  ASSERT_NE(temp_3, nullptr);
+  EXPECT_NE(temp, temp_2);
+  EXPECT_EQ(3, pxd::memory::total_allocated_memory());
+
+  pxd::memory::free(temp);
+  pxd::memory::free(temp_2);
+  pxd::memory::free(temp_3);
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+
+  pxd::memory::release_memory();
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * the objects of the test framework may be allocated from the pool too, so
+ * the pool is created once and never released
+ */
+
+namespace {
+
+struct alignas(256) OverAligned
+{
+  uint8_t value = 0;
+};
+
+void
+init_pool()
+{
+  static const bool is_initialized = []() {
+    pxd::memory::PoolOptions options = {};
+    options.thread_safe              = true;
+
+    pxd::memory::alloc_memory(pxd::memory::SIZE_1MB, options);
+    return true;
+  }();
+
+  static_cast<void>(is_initialized);
+}
+
+} // namespace
+
+TEST(NewDelete, FallbackBeforeInit)
+{
+  if (pxd::memory::default_pool().owns(std::make_unique<int>().get())) {
+    GTEST_SKIP() << "the pool is already initialized";
+  }
+
+  auto* value = new int(42);
+
+  EXPECT_FALSE(pxd::memory::default_pool().owns(value));
+
+  delete value;
+}
+
+TEST(NewDelete, Pool)
+{
+  init_pool();
+
+  const size_t allocated = pxd::memory::total_allocated_memory();
+
+  {
+    auto                       value = std::make_unique<int64_t>(42);
+    std::vector<int>           numbers(100, 1);
+    std::map<int, std::string> names;
+
+    names.emplace(1, "a string too long for the small string buffer");
+
+    EXPECT_TRUE(pxd::memory::default_pool().owns(value.get()));
+    EXPECT_TRUE(pxd::memory::default_pool().owns(numbers.data()));
+    EXPECT_EQ(0,
+              reinterpret_cast<uintptr_t>(value.get()) %
+                __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    auto aligned = std::make_unique<OverAligned>();
+
+    EXPECT_TRUE(pxd::memory::default_pool().owns(aligned.get()));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned.get()) % 256);
+
+    auto* array = new OverAligned[4];
+
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(array) % 256);
+
+    delete[] array;
+
+    auto* empty = new char[0];
+
+    EXPECT_NE(nullptr, empty);
+
+    delete[] empty;
+  }
+
+  EXPECT_EQ(allocated, pxd::memory::total_allocated_memory());
+}
+
+TEST(NewDelete, FallbackWhenFull)
+{
+  init_pool();
+
+  std::vector<uint8_t> large(2 * pxd::memory::SIZE_1MB, 1);
+
+  EXPECT_FALSE(pxd::memory::default_pool().owns(large.data()));
+  EXPECT_EQ(1, large.back());
+}
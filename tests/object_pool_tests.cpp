@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "../includes/object_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace {
+
+struct Counted
+{
+  static inline int alive = 0;
+
+  explicit Counted(int value)
+    : value(value)
+  {
+    alive++;
+  }
+
+  Counted(const Counted& other)            = delete;
+  Counted& operator=(const Counted& other) = delete;
+  Counted(Counted&& other)                 = delete;
+  Counted& operator=(Counted&& other)      = delete;
+  ~Counted() { alive--; }
+
+  int value;
+};
+
+} // namespace
+
+TEST(ObjectPool, ReuseFreedSlot)
+{
+  pxd::memory::MemoryPool            pool(pxd::memory::SIZE_1MB);
+  pxd::memory::object_pool<uint64_t> objects(pool);
+
+  uint64_t* first  = objects.allocate();
+  uint64_t* second = objects.allocate();
+
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(first + 1, second);
+
+  objects.deallocate(first);
+
+  EXPECT_EQ(first, objects.allocate());
+  EXPECT_EQ(1, objects.slab_count());
+}
+
+TEST(ObjectPool, SlabsFromPool)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB);
+
+  {
+    pxd::memory::object_pool<uint32_t> objects(pool, 16);
+
+    std::vector<uint32_t*> blocks;
+
+    for (size_t i = 0; i < 40; i++) {
+      blocks.push_back(objects.allocate());
+      ASSERT_NE(blocks.back(), nullptr);
+    }
+
+    EXPECT_EQ(3, objects.slab_count());
+    EXPECT_EQ(3 * 16 * pxd::memory::object_pool<uint32_t>::SLOT_SIZE,
+              pool.total_allocated_memory());
+  }
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+  EXPECT_EQ(pxd::memory::SIZE_1MB, pool.max_free_memory());
+}
+
+TEST(ObjectPool, CreateDestroy)
+{
+  pxd::memory::MemoryPool           pool(pxd::memory::SIZE_1MB);
+  pxd::memory::object_pool<Counted> objects(pool);
+
+  Counted* object = objects.create(42);
+
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(42, object->value);
+  EXPECT_EQ(1, Counted::alive);
+
+  objects.destroy(object);
+
+  EXPECT_EQ(0, Counted::alive);
+}
+
+TEST(ObjectPool, Full)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool            pool(64);
+  pxd::memory::object_pool<uint64_t> objects(pool, 4);
+
+  for (size_t i = 0; i < 8; i++) {
+    EXPECT_NE(objects.allocate(), nullptr);
+  }
+
+  EXPECT_EQ(objects.allocate(), nullptr);
+}
+
+TEST(ObjectPool, Containers)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB);
+
+  {
+    pxd::memory::object_allocator<int> alloc(pool);
+
+    std::list<int, pxd::memory::object_allocator<int>> temp_list(alloc);
+
+    for (int i = 0; i < 100; i++) {
+      temp_list.push_back(i);
+    }
+
+    std::map<int,
+             int,
+             std::less<>,
+             pxd::memory::object_allocator<std::pair<const int, int>>>
+      temp_map(alloc);
+
+    for (int i = 0; i < 100; i++) {
+      temp_map.emplace(i, i * 2);
+    }
+
+    std::vector<int, pxd::memory::object_allocator<int>> temp_vec(50, alloc);
+
+    EXPECT_EQ(99, temp_list.back());
+    EXPECT_EQ(198, temp_map.at(99));
+    EXPECT_LT(0, pool.total_allocated_memory());
+    EXPECT_EQ(&pool, temp_list.get_allocator().pool());
+
+    auto moved = std::move(temp_list);
+
+    temp_list.push_back(1);
+
+    EXPECT_EQ(100, moved.size());
+    EXPECT_EQ(1, temp_list.size());
+  }
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+}
+
+TEST(ObjectPool, RebindSharesObjectPools)
+{
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB);
+
+  pxd::memory::object_allocator<int>    alloc(pool);
+  pxd::memory::object_allocator<double> rebound(alloc);
+
+  EXPECT_TRUE(alloc == rebound);
+  EXPECT_TRUE(alloc == pxd::memory::object_allocator<int>(rebound));
+  EXPECT_FALSE(alloc == pxd::memory::object_allocator<int>(pool));
+
+  double* object = rebound.allocate(1);
+
+  pxd::memory::object_allocator<double> other(
+    pxd::memory::object_allocator<int>{ rebound });
+
+  other.deallocate(object, 1);
+
+  EXPECT_EQ(object, rebound.allocate(1));
+
+  std::list<int, pxd::memory::object_allocator<int>> first(alloc);
+  std::list<int, pxd::memory::object_allocator<int>> second(alloc);
+
+  first.push_back(1);
+
+  const int* node = &first.back();
+
+  first.pop_back();
+  second.push_back(2);
+
+  EXPECT_EQ(node, &second.back());
+}
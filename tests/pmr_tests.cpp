@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "../includes/memory_resource.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST(Pmr, Containers)
+{
+  pxd::memory::MemoryPool    pool(pxd::memory::SIZE_1MB);
+  pxd::memory::pool_resource resource(pool);
+
+  {
+    std::pmr::vector<int> temp_vec(50, 1, &resource);
+
+    EXPECT_EQ(200, pool.total_allocated_memory());
+
+    std::pmr::unordered_map<int, std::pmr::string> temp_map(&resource);
+
+    for (int i = 0; i < 100; i++) {
+      temp_map.emplace(i, "a string too long for the small string buffer");
+    }
+
+    EXPECT_EQ(100, temp_map.size());
+    EXPECT_LT(200, pool.total_allocated_memory());
+    EXPECT_EQ(&resource, temp_map.at(7).get_allocator().resource());
+  }
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+}
+
+TEST(Pmr, Alignment)
+{
+  pxd::memory::MemoryPool    pool(pxd::memory::SIZE_1MB);
+  pxd::memory::pool_resource resource(pool);
+
+  void* aligned = resource.allocate(100, 256);
+
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 256);
+
+  resource.deallocate(aligned, 100, 256);
+
+  void* empty = resource.allocate(0, 8);
+
+  EXPECT_NE(nullptr, empty);
+
+  resource.deallocate(empty, 0, 8);
+
+  EXPECT_EQ(0, pool.total_allocated_memory());
+  EXPECT_THROW(static_cast<void>(resource.allocate(2 * pxd::memory::SIZE_1MB)),
+               std::bad_alloc);
+}
+
+TEST(Pmr, Equality)
+{
+  pxd::memory::MemoryPool pool(1024);
+  pxd::memory::MemoryPool other_pool(1024);
+
+  pxd::memory::pool_resource first(pool);
+  pxd::memory::pool_resource second(pool);
+  pxd::memory::pool_resource third(other_pool);
+
+  EXPECT_TRUE(first.is_equal(second));
+  EXPECT_FALSE(first.is_equal(third));
+  EXPECT_FALSE(first.is_equal(*std::pmr::new_delete_resource()));
+  EXPECT_EQ(&pxd::memory::default_pool(),
+            pxd::memory::default_pool_resource()->pool());
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "../includes/allocator.hpp"
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <list>
+#include <new>
+#include <vector>
+
+TEST(Pool, Independent)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(128);
+  pxd::memory::MemoryPool pool_2(256);
+
+  void* temp   = pool.malloc(30);
+  void* temp_2 = pool_2.malloc(100);
+
+  EXPECT_EQ(98, pool.total_free_memory());
+  EXPECT_EQ(156, pool_2.total_free_memory());
+
+  pool.free(temp_2);
+
+  EXPECT_EQ(100, pool_2.total_allocated_memory());
+
+  pool_2.free(temp_2);
+  pool.free(temp);
+
+  EXPECT_EQ(128, pool.total_free_memory());
+  EXPECT_EQ(256, pool_2.total_free_memory());
+}
+
+TEST(Pool, DefaultPool)
+{
+  pxd::memory::alloc_memory(128);
+
+  void* temp = pxd::memory::default_pool().malloc(10);
+
+  EXPECT_EQ(10, pxd::memory::total_allocated_memory());
+
+  pxd::memory::free(temp);
+  pxd::memory::release_memory();
+}
+
+TEST(Pool, Allocator)
+{
+  pxd::memory::MemoryPool pool(1024);
+
+  pxd::memory::allocator<int> alloc(pool);
+
+  std::vector<int, pxd::memory::allocator<int>> temp_vec(50, alloc);
+
+  EXPECT_EQ(200, pool.total_allocated_memory());
+
+  std::list<int, pxd::memory::allocator<int>> temp_list(alloc);
+
+  temp_list.push_back(1);
+  temp_list.push_back(2);
+
+  EXPECT_LT(200, pool.total_allocated_memory());
+  EXPECT_EQ(pxd::memory::allocator<int>(pool), temp_list.get_allocator());
+  EXPECT_NE(pxd::memory::allocator<int>(), temp_list.get_allocator());
+}
+
+TEST(Pool, ThreadSafe)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  auto pool = std::make_unique<pxd::memory::MemoryPool>(pxd::memory::SIZE_1MB,
+                                                        options);
+
+  void* temp = pool->malloc(32);
+
+  EXPECT_EQ(32, pool->total_allocated_memory());
+
+  pool->free(temp);
+  pool.reset();
+
+  pxd::memory::MemoryPool pool_2(pxd::memory::SIZE_1MB, options);
+
+  void* temp_2 = pool_2.malloc(32);
+
+  EXPECT_EQ(32, pool_2.total_allocated_memory());
+
+  pool_2.free(temp_2);
+
+  EXPECT_EQ(pxd::memory::SIZE_1MB, pool_2.total_free_memory());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+TEST(Realloc, GrowInPlace)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  auto* arr = static_cast<int*>(pxd::memory::malloc(4 * sizeof(int)));
+
+  for (int i = 0; i < 4; ++i) {
+    arr[i] = i + 1;
+  }
+
+  auto* grown = static_cast<int*>(pxd::memory::realloc(arr, 8 * sizeof(int)));
+
+  EXPECT_EQ(arr, grown);
+  EXPECT_EQ(32, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(96, pxd::memory::total_free_memory());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i + 1, grown[i]);
+  }
+
+  pxd::memory::release_memory();
+}
+
+TEST(Realloc, ShrinkInPlace)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  void* temp   = pxd::memory::malloc(40);
+  void* temp_2 = pxd::memory::malloc(10);
+
+  void* shrunk = pxd::memory::realloc(temp, 16);
+
+  EXPECT_EQ(temp, shrunk);
+  EXPECT_EQ(26, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(78, pxd::memory::max_free_memory());
+  EXPECT_EQ(24, pxd::memory::min_free_memory());
+
+  pxd::memory::free(temp_2);
+
+  EXPECT_EQ(112, pxd::memory::max_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Realloc, Move)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  auto* temp   = static_cast<char*>(pxd::memory::malloc(10));
+  void* temp_2 = pxd::memory::malloc(10);
+
+  for (int i = 0; i < 10; ++i) {
+    temp[i] = static_cast<char>('a' + i);
+  }
+
+  auto* moved = static_cast<char*>(pxd::memory::realloc(temp, 20));
+
+  EXPECT_NE(temp, moved);
+  EXPECT_EQ(30, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(98, pxd::memory::total_free_memory());
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(static_cast<char>('a' + i), moved[i]);
+  }
+
+  pxd::memory::release_memory();
+}
+
+TEST(Realloc, Failure)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::alloc_memory(128);
+
+  void* temp   = pxd::memory::malloc(60);
+  void* temp_2 = pxd::memory::malloc(10);
+
+  EXPECT_EQ(nullptr, pxd::memory::realloc(temp, 100));
+  EXPECT_EQ(70, pxd::memory::total_allocated_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Realloc, NullAndZero)
+{
+  pxd::memory::alloc_memory(128);
+
+  void* temp = pxd::memory::realloc(nullptr, 10);
+
+  EXPECT_NE(temp, nullptr);
+  EXPECT_EQ(10, pxd::memory::total_allocated_memory());
+
+  EXPECT_EQ(nullptr, pxd::memory::realloc(temp, 0));
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(128, pxd::memory::total_free_memory());
+
+  pxd::memory::release_memory();
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+auto
+is_zero(const uint8_t* data, size_t size) -> bool
+{
+  for (size_t i = 0; i < size; i++) {
+    if (data[i] != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
+TEST(Scrub, CallocAfterDirtyFree)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(256);
+
+  auto* dirty = static_cast<uint8_t*>(pool.malloc(128));
+
+  ASSERT_NE(dirty, nullptr);
+
+  std::memset(dirty, 0xAB, 128);
+
+  pool.free(dirty);
+
+  auto* clean = static_cast<uint8_t*>(pool.calloc(256));
+
+  ASSERT_NE(clean, nullptr);
+  EXPECT_TRUE(is_zero(clean, 256));
+
+  pool.free(clean);
+}
+
+TEST(Scrub, ZeroOnFree)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.scrub                    = pxd::memory::ScrubMode::ZERO_ON_FREE;
+
+  pxd::memory::MemoryPool pool(256, options);
+
+  auto* dirty = static_cast<uint8_t*>(pool.malloc(128));
+
+  ASSERT_NE(dirty, nullptr);
+
+  std::memset(dirty, 0xAB, 128);
+
+  pool.free(dirty);
+
+  /*
+   * the free blocks are poisoned under asan, so the scrubbed bytes are read
+   * through the allocation which reuses them
+   */
+  auto* reused = static_cast<uint8_t*>(pool.malloc(128));
+
+  ASSERT_EQ(dirty, reused);
+  EXPECT_TRUE(is_zero(reused, 128));
+
+  pool.free(reused);
+
+  auto* clean = static_cast<uint8_t*>(pool.calloc(256));
+
+  ASSERT_NE(clean, nullptr);
+  EXPECT_TRUE(is_zero(clean, 256));
+
+  pool.free(clean);
+}
+
+TEST(Scrub, ZeroOnAlloc)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::PoolOptions options = {};
+  options.scrub                    = pxd::memory::ScrubMode::ZERO_ON_ALLOC;
+
+  pxd::memory::MemoryPool pool(256, options);
+
+  auto* dirty = static_cast<uint8_t*>(pool.malloc(128));
+
+  ASSERT_NE(dirty, nullptr);
+
+  std::memset(dirty, 0xAB, 128);
+
+  pool.free(dirty);
+
+  auto* clean = static_cast<uint8_t*>(pool.malloc(256));
+
+  ASSERT_NE(clean, nullptr);
+  EXPECT_TRUE(is_zero(clean, 256));
+
+  pool.free(clean);
+}
+
+TEST(Scrub, ThreadCache)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  auto* dirty = static_cast<uint8_t*>(pool.malloc(32));
+
+  ASSERT_NE(dirty, nullptr);
+
+  std::memset(dirty, 0xAB, 32);
+
+  pool.free(dirty);
+
+  auto* clean = static_cast<uint8_t*>(pool.calloc(32));
+
+  ASSERT_NE(clean, nullptr);
+  EXPECT_TRUE(is_zero(clean, 32));
+
+  pool.free(clean);
+}
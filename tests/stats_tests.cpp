@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+#include "test_helpers.hpp"
+
+#include <thread>
+#include <vector>
+
+TEST(Stats, Counters)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(128);
+
+  void* temp   = pool.malloc(10);
+  void* temp_2 = pool.malloc(20);
+  void* temp_3 = pool.malloc(30);
+
+  pool.free(temp_2);
+
+  pxd::memory::PoolStats stats = pool.stats();
+
+  EXPECT_EQ(40, stats.allocated_bytes);
+  EXPECT_EQ(88, stats.free_bytes);
+  EXPECT_EQ(60, stats.peak_bytes);
+  EXPECT_EQ(68, stats.largest_free_block);
+  EXPECT_EQ(20, stats.smallest_free_block);
+  EXPECT_EQ(3, stats.alloc_count);
+  EXPECT_EQ(1, stats.free_count);
+  EXPECT_EQ(0, stats.failed_count);
+
+  EXPECT_EQ(nullptr, pool.malloc(100));
+
+  pool.free(temp_2);
+
+  temp = pool.realloc(temp, 25);
+
+  stats = pool.stats();
+
+  EXPECT_EQ(55, stats.allocated_bytes);
+  EXPECT_EQ(60, stats.peak_bytes);
+  EXPECT_EQ(1, stats.free_count);
+  EXPECT_EQ(1, stats.failed_count);
+
+  pool.free(temp);
+  pool.free(temp_3);
+
+  stats = pool.stats();
+
+  EXPECT_EQ(0, stats.allocated_bytes);
+  EXPECT_EQ(128, stats.free_bytes);
+  EXPECT_EQ(128, stats.largest_free_block);
+  EXPECT_EQ(128, stats.smallest_free_block);
+  EXPECT_EQ(3, stats.free_count);
+
+  pool.release_memory();
+
+  stats = pool.stats();
+
+  EXPECT_EQ(0, stats.free_bytes);
+  EXPECT_EQ(0, stats.peak_bytes);
+  EXPECT_EQ(0, stats.alloc_count);
+}
+
+TEST(Stats, ThreadCaches)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1MB, options);
+
+  std::vector<void*> blocks;
+
+  for (size_t i = 0; i < 100; i++) {
+    blocks.push_back(pool.malloc(32));
+  }
+
+  std::thread remote([&pool, &blocks]() {
+    for (size_t i = 0; i < 50; i++) {
+      pool.free(blocks[i]);
+    }
+  });
+
+  remote.join();
+
+  for (size_t i = 50; i < 100; i++) {
+    pool.free(blocks[i]);
+  }
+
+  const pxd::memory::PoolStats stats = pool.stats();
+
+  EXPECT_EQ(100, stats.alloc_count);
+  EXPECT_EQ(100, stats.free_count);
+  EXPECT_EQ(0, stats.allocated_bytes);
+  EXPECT_EQ(pxd::memory::SIZE_1MB, stats.free_bytes);
+}
+
+TEST(Stats, Snapshot)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(pxd::memory::SIZE_1KB);
+
+  std::vector<void*> blocks;
+
+  for (size_t i = 0; i < 8; i++) {
+    blocks.push_back(pool.malloc(64));
+  }
+
+  for (size_t i = 0; i < 8; i += 2) {
+    pool.free(blocks[i]);
+  }
+
+  const pxd::memory::PoolSnapshot snapshot = pool.snapshot();
+
+  EXPECT_EQ(4, snapshot.free_histogram[6]);
+  EXPECT_EQ(1, snapshot.free_histogram[9]);
+  EXPECT_EQ(4, snapshot.allocated_histogram[6]);
+  EXPECT_EQ(768, snapshot.total_free_bytes);
+  EXPECT_EQ(512, snapshot.largest_free_block);
+  EXPECT_DOUBLE_EQ(1.0 - 512.0 / 768.0, snapshot.fragmentation);
+
+  EXPECT_EQ(512, snapshot.largest_aligned_block[0]);
+  EXPECT_EQ(512, snapshot.largest_aligned_block[6]);
+  EXPECT_GE(512, snapshot.largest_aligned_block[12]);
+
+  EXPECT_EQ(nullptr, pool.malloc(600));
+}
+
+TEST(Stats, LayoutJson)
+{
+  PXD_SKIP_IF_HARDENED();
+
+  pxd::memory::MemoryPool pool(128);
+
+  void* temp = pool.malloc(10);
+
+  static_cast<void>(pool.malloc(20));
+
+  pool.free(temp);
+
+  EXPECT_EQ("{\n"
+            "  \"size\": 128,\n"
+            "  \"free\": [\n"
+            "    {\"start\": 0, \"size\": 10},\n"
+            "    {\"start\": 30, \"size\": 98}\n"
+            "  ],\n"
+            "  \"allocated\": [\n"
+            "    {\"start\": 10, \"size\": 20}\n"
+            "  ]\n"
+            "}\n",
+            pool.layout_json());
+
+  pool.release_memory();
+
+  EXPECT_EQ("{\n"
+            "  \"size\": 0,\n"
+            "  \"free\": [\n"
+            "  ],\n"
+            "  \"allocated\": [\n"
+            "  ]\n"
+            "}\n",
+            pool.layout_json());
+}
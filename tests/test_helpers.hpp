@@ -0,0 +1,29 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+
+#include <cstddef>
+
+namespace pxd::memory::test {
+
+/*
+ * the bytes the guards of the hardened build add to every allocation
+ */
+constexpr size_t GUARDS = 2 * GUARD_SIZE;
+
+} // namespace pxd::memory::test
+
+/*
+ * skips a test whose expectations only hold without the guards of the
+ * hardened build, because they depend on where the blocks end up or free
+ * memory twice on purpose. hardened_tests.cpp checks the same paths with the
+ * guards in place
+ */
+#define PXD_SKIP_IF_HARDENED()                                                 \
+  do {                                                                         \
+    if (pxd::memory::GUARD_SIZE > 0) {                                         \
+      GTEST_SKIP() << "the guards of the hardened build move the blocks";      \
+    }                                                                          \
+  } while (false)
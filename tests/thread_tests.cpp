@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "../includes/memory_pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(Thread, ParallelMallocFree)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::alloc_memory(16 * pxd::memory::SIZE_1MB, options);
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < 8; ++i) {
+    threads.emplace_back([i]() {
+      std::vector<uint8_t*> blocks;
+
+      for (size_t j = 0; j < 1000; ++j) {
+        const size_t size  = ((i * 31 + j * 17) % 600) + 1;
+        auto*        block = static_cast<uint8_t*>(pxd::memory::malloc(size));
+
+        ASSERT_NE(block, nullptr);
+
+        block[0]        = static_cast<uint8_t>(i);
+        block[size - 1] = static_cast<uint8_t>(i);
+
+        blocks.push_back(block);
+      }
+
+      for (uint8_t* block : blocks) {
+        EXPECT_EQ(block[0], static_cast<uint8_t>(i));
+        pxd::memory::free(block);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(16 * pxd::memory::SIZE_1MB, pxd::memory::total_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Thread, RemoteFree)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::alloc_memory(pxd::memory::SIZE_1MB, options);
+
+  std::vector<void*> blocks;
+
+  for (size_t i = 0; i < 100; ++i) {
+    blocks.push_back(pxd::memory::malloc(32));
+  }
+
+  EXPECT_EQ(3200, pxd::memory::total_allocated_memory());
+
+  std::thread consumer([&blocks]() {
+    for (void* block : blocks) {
+      pxd::memory::free(block);
+    }
+  });
+
+  consumer.join();
+
+  EXPECT_EQ(0, pxd::memory::total_allocated_memory());
+  EXPECT_EQ(pxd::memory::SIZE_1MB, pxd::memory::total_free_memory());
+
+  void* reused = pxd::memory::malloc(32);
+
+  EXPECT_NE(std::find(blocks.begin(), blocks.end(), reused), blocks.end());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Thread, SmallPool)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::alloc_memory(128, options);
+
+  void* temp = pxd::memory::malloc(10);
+
+  EXPECT_NE(temp, nullptr);
+  EXPECT_EQ(10, pxd::memory::total_allocated_memory());
+
+  pxd::memory::free(temp);
+
+  EXPECT_EQ(128, pxd::memory::total_free_memory());
+
+  pxd::memory::release_memory();
+}
+
+TEST(Thread, ReleaseFreeSpans)
+{
+  pxd::memory::PoolOptions options = {};
+  options.thread_safe              = true;
+
+  pxd::memory::alloc_memory(pxd::memory::SIZE_1MB, options);
+
+  std::vector<void*> blocks;
+
+  for (void* block = pxd::memory::malloc(16); block != nullptr;
+       block       = pxd::memory::malloc(16)) {
+    blocks.push_back(block);
+  }
+
+  for (void* block : blocks) {
+    pxd::memory::free(block);
+  }
+
+  EXPECT_EQ(pxd::memory::SIZE_1MB, pxd::memory::total_free_memory());
+
+  void* large = pxd::memory::malloc(512 * pxd::memory::SIZE_1KB);
+
+  EXPECT_NE(large, nullptr);
+
+  void*       other_block = nullptr;
+  std::thread other([&other_block]() {
+    other_block = pxd::memory::malloc(16);
+  });
+
+  other.join();
+
+  EXPECT_NE(other_block, nullptr);
+
+  pxd::memory::free(other_block);
+  pxd::memory::free(large);
+  pxd::memory::release_memory();
+}